@@ -0,0 +1,162 @@
+/*
+ * \file AsymmetricFence.cpp
+ * \brief Source file de::Koesling::Signal::AsymmetricFence
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "AsymmetricFence.hpp"
+#include "Futex.hpp"
+#include "RealtimeSignals.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <linux/membarrier.h>
+#include <memory>
+#include <sys/syscall.h>
+#include <sysexits.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+AsymmetricFence::AsymmetricFence(bool try_membarrier) :
+        signal_number(RealtimeSignals::reserve( )),
+        signal_handler(signal_number, SignalTrampoline::handler, SA_RESTART),
+        use_membarrier(false)
+{
+    if (try_membarrier)
+    {
+        const long commands = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0);
+        if (commands > 0 && (commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED))
+            use_membarrier = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+    }
+
+    try
+    {
+        SignalTrampoline::attach(signal_number, this);
+    }
+    catch (...)
+    {
+        RealtimeSignals::release(signal_number);
+        throw;
+    }
+
+    try
+    {
+        signal_handler.establish( );
+    }
+    catch (...)
+    {
+        SignalTrampoline::detach(signal_number, this);
+        RealtimeSignals::release(signal_number);
+        throw;
+    }
+}
+
+AsymmetricFence::~AsymmetricFence( )
+{
+    try
+    {
+        signal_handler.revoke( );
+    }
+    catch (const std::exception &e) // system call failed
+    {
+        destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+    }
+    SignalTrampoline::detach(signal_number, this);
+    RealtimeSignals::release(signal_number);
+}
+
+void AsymmetricFence::on_signal(int, siginfo_t *info, void*) noexcept
+{
+    // only accept requests of this process
+    if (info->si_code != SI_QUEUE || info->si_pid != getpid( )) return;
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    std::atomic<std::uint32_t> *done = static_cast<std::atomic<std::uint32_t>*>(info->si_value.sival_ptr);
+    done->store(1, std::memory_order_release);
+    futex_wake(*done);
+}
+
+void AsymmetricFence::request(pthread_t thread, std::atomic<std::uint32_t> &ack)
+{
+    union sigval value;
+    value.sival_ptr = &ack;
+
+    // pthread_sigqueue does not use errno
+    int temp = pthread_sigqueue(thread, signal_number, value);
+    sysexcept(temp != 0, "pthread_sigqueue", temp);
+}
+
+void AsymmetricFence::wait(std::atomic<std::uint32_t> &ack) noexcept
+{
+    while (ack.load(std::memory_order_acquire) == 0)
+        futex_wait(ack, 0);
+}
+
+void AsymmetricFence::heavy(pthread_t thread)
+{
+    std::atomic<std::uint32_t> ack(0);
+
+    // the caller's stores must be visible before the signal is sent
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // ack lives on this stack: wait unconditionally
+    request(thread, ack);
+    wait(ack);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void AsymmetricFence::heavy(const std::vector<pthread_t> &threads)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (use_membarrier)
+    {
+        long temp = syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+        sysexcept(temp != 0, "membarrier", errno);
+    }
+    else
+    {
+        // signal all threads before waiting: the handlers run in parallel
+        std::unique_ptr<std::atomic<std::uint32_t>[]> acks(new std::atomic<std::uint32_t>[threads.size( )]);
+        for (std::size_t i = 0; i < threads.size( ); ++i)
+            acks[i].store(0, std::memory_order_relaxed);
+
+        std::size_t sent = 0;
+        try
+        {
+            for (; sent < threads.size( ); ++sent)
+                request(threads[sent], acks[sent]);
+        }
+        catch (...)
+        {
+            // the acks are referenced by the sent requests
+            for (std::size_t i = 0; i < sent; ++i)
+                wait(acks[i]);
+            throw;
+        }
+
+        for (std::size_t i = 0; i < sent; ++i)
+            wait(acks[i]);
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
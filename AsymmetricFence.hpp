@@ -0,0 +1,130 @@
+/*
+ * \file AsymmetricFence.hpp
+ * \brief Header file de::Koesling::Signal::AsymmetricFence
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalHandler.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <cstdint>
+#include <pthread.h>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Asymmetric memory fence
+ *
+ * The fast side (executed often) only uses light(): a compiler barrier, no
+ * fence instruction. The slow side (executed rarely) calls heavy(thread):
+ * a reserved realtime signal is sent to the thread and its handler executes
+ * a full memory fence and acknowledges it. After heavy() returns, all
+ * memory operations of the thread that precede the (light) barrier at the
+ * interrupted point are visible, and all later operations of the thread
+ * observe the stores of the caller that precede heavy().
+ *
+ * heavy() waits until the thread handled the signal: the thread must not
+ * block the signal permanently and must exist until heavy() returns.
+ *
+ * If the kernel supports membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED), the
+ * heavy side for several threads is a single system call (interprocessor
+ * interrupts instead of signals).
+ */
+class AsymmetricFence : private SignalSink
+{
+    private:
+        //! reserved realtime signal
+        int signal_number;
+
+        //! installed trampoline
+        SignalHandler signal_handler;
+
+        //! process is registered for private expedited membarrier
+        bool use_membarrier;
+
+        //! send fence request (ack is set by the handler)
+        void request(pthread_t thread, std::atomic<std::uint32_t> &ack);
+
+        //! wait for acknowledge of a fence request
+        static void wait(std::atomic<std::uint32_t> &ack) noexcept;
+
+        //! fence and acknowledge (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+    public:
+        /*! \brief reserve signal and install handler
+         *
+         * attributes:
+         *   try_membarrier: use membarrier for heavy(threads) if available
+         * possible_throws:
+         *   std::runtime_error: no free realtime signal
+         *   std::system_error : a system call failed
+         */
+        explicit AsymmetricFence(bool try_membarrier = true);
+
+        //! revoke handler and release signal
+        ~AsymmetricFence( );
+
+        //! fast side barrier (compiler barrier only)
+        inline static void light( ) noexcept;
+
+        /*! \brief slow side barrier: serialize memory of thread
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed (e.g. thread does not exist)
+         */
+        void heavy(pthread_t thread);
+
+        /*! \brief slow side barrier: serialize memory of several threads
+         *
+         * Uses membarrier if available, otherwise all threads are signaled
+         * (in parallel).
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed (e.g. thread does not exist)
+         */
+        void heavy(const std::vector<pthread_t> &threads);
+
+        //! check if heavy(threads) uses membarrier
+        inline bool uses_membarrier( ) const noexcept;
+
+        //! get the reserved signal
+        inline int get_signal_number( ) const noexcept;
+
+        //! copying not allowed
+        AsymmetricFence(const AsymmetricFence &other) = delete;
+        //! copying not allowed
+        AsymmetricFence& operator=(const AsymmetricFence &other) = delete;
+};
+
+inline void AsymmetricFence::light( ) noexcept
+{
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+inline bool AsymmetricFence::uses_membarrier( ) const noexcept
+{
+    return use_membarrier;
+}
+
+inline int AsymmetricFence::get_signal_number( ) const noexcept
+{
+    return signal_number;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,140 @@
+/*
+ * \file BatchSignalHandler.cpp
+ * \brief Source file de::Koesling::Signal::BatchSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "BatchSignalHandler.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <stdexcept>
+#include <sysexits.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+BatchSignalHandler::BatchSignalHandler(int signal_number, SignalBatchHandler_t handler_function,
+        std::size_t queue_capacity, std::size_t max_batch, int sa_flags, sigset_t *blocked_signals) :
+        signal_number(signal_number),
+        handler_function(std::move(handler_function)),
+        queue(queue_capacity),
+        stop(false),
+        batches(0),
+        signal_handler(signal_number, SignalTrampoline::handler, sa_flags, blocked_signals)
+{
+    if (!this->handler_function)
+        throw std::invalid_argument("Unable to establish a signal handler with no handler function.");
+
+    batch.reserve(max_batch == 0 ? queue.get_capacity( ) : max_batch);
+
+    int temp = sem_init(&semaphore, 0, 0);
+    sysexcept(temp != 0, "sem_init", errno);
+
+    try
+    {
+        SignalTrampoline::attach(signal_number, this);
+    }
+    catch (...)
+    {
+        sem_destroy(&semaphore);
+        throw;
+    }
+
+    try
+    {
+        dispatcher = std::thread(&BatchSignalHandler::dispatch, this);
+    }
+    catch (...)
+    {
+        SignalTrampoline::detach(signal_number, this);
+        sem_destroy(&semaphore);
+        throw;
+    }
+}
+
+BatchSignalHandler::~BatchSignalHandler( )
+{
+    // restore previous handler before the sink is detached
+    if (signal_handler.is_established( ))
+    {
+        try
+        {
+            signal_handler.revoke( );
+        }
+        catch (const std::exception &e) // system call failed
+        {
+            destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+        }
+    }
+
+    SignalTrampoline::detach(signal_number, this);
+
+    stop.store(true);
+    sem_post(&semaphore);
+    dispatcher.join( );
+    sem_destroy(&semaphore);
+}
+
+void BatchSignalHandler::on_signal(int, siginfo_t *info, void*) noexcept
+{
+    SignalEvent event;
+    to_signal_event(*info, monotonic_ns( ), event);
+    if (queue.push(event)) sem_post(&semaphore);
+}
+
+void BatchSignalHandler::dispatch( )
+{
+    const std::size_t max_batch = batch.capacity( );
+
+    for (;;)
+    {
+        while (sem_wait(&semaphore) == -1 && errno == EINTR)
+            ;
+
+        // the events of further posts are collected by this batch
+        while (sem_trywait(&semaphore) == 0)
+            ;
+
+        SignalEvent event;
+        for (;;)
+        {
+            batch.clear( );
+            while (batch.size( ) < max_batch && queue.pop(event))
+                batch.push_back(event);
+            if (batch.empty( )) break;
+
+            batches.fetch_add(1, std::memory_order_relaxed);
+            try
+            {
+                handler_function(SignalEventSpan { batch.data( ), batch.size( ) });
+            }
+            catch (const std::exception &e)
+            {
+                SignalHandler::get_error_stream( ) << "BatchSignalHandler: handler function for signal "
+                        << signal_number << " failed: " << e.what( ) << std::endl;
+            }
+            catch (...)
+            {
+                SignalHandler::get_error_stream( ) << "BatchSignalHandler: handler function for signal "
+                        << signal_number << " failed: unknown exception" << std::endl;
+            }
+        }
+
+        if (stop.load( )) break;
+    }
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,169 @@
+/*
+ * \file BatchSignalHandler.hpp
+ * \brief Header file de::Koesling::Signal::BatchSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalHandler.hpp"
+#include "SignalEvent.hpp"
+#include "SignalEventQueue.hpp"
+#include "SignalThreadConfig.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <semaphore.h>
+#include <thread>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! batch handler function type (all events captured since the last call)
+typedef std::function<void(SignalEventSpan)> SignalBatchHandler_t;
+
+/*! \brief Signal handler that passes batches of events to the handler function
+ *
+ * The installed signal handler (trampoline) only captures the siginfo_t into
+ * a lock free queue and wakes a dispatcher thread. The dispatcher thread
+ * calls the handler function (in normal thread context) with all events that
+ * were captured since the last call (up to max_batch events per call).
+ *
+ * Note: standard signals (< SIGRTMIN) are merged by the kernel while they
+ * are pending. A SIGCHLD event may therefore stand for several terminated
+ * children (use waitid/waitpid with WNOHANG in the handler function).
+ */
+class BatchSignalHandler : private SignalSink
+{
+    private:
+        //! signal number
+        int signal_number;
+
+        //! handler function
+        SignalBatchHandler_t handler_function;
+
+        //! events captured by the trampoline
+        SignalEventQueue queue;
+
+        //! events of the current batch
+        std::vector<SignalEvent> batch;
+
+        //! wakes the dispatcher thread (sem_post is async-signal-safe)
+        sem_t semaphore;
+
+        //! stop the dispatcher thread
+        std::atomic<bool> stop;
+
+        //! number of handler function calls
+        std::atomic<std::uint64_t> batches;
+
+        //! dispatcher thread
+        std::thread dispatcher;
+
+        //! installed trampoline
+        SignalHandler signal_handler;
+
+        //! capture event (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+        //! dispatcher thread
+        void dispatch( );
+
+    public:
+        /*! \brief init BatchSignalHandler
+         *
+         * attributes:
+         *   signal_number   : signal which will be handled by this handler
+         *   handler_function: function that is called with each batch
+         *   queue_capacity  : maximum number of events that are not yet
+         *                     dispatched (further events are dropped)
+         *   max_batch       : maximum number of events per call
+         *                     (0: queue capacity)
+         *   sa_flags        : see man sigaction (sa_flags)
+         *   blocked_signals : see man sigaction (sa_mask)
+         * possible_throws:
+         *   std::invalid_argument: invalid argument
+         *   std::logic_error     : another sink is attached to the signal
+         *   std::system_error    : a system call failed
+         */
+        BatchSignalHandler(int signal_number, SignalBatchHandler_t handler_function,
+                std::size_t queue_capacity = 1024, std::size_t max_batch = 0, int sa_flags = SA_RESTART,
+                sigset_t *blocked_signals = nullptr);
+
+        //! revoke handler, dispatch all captured events and stop dispatcher thread
+        ~BatchSignalHandler( );
+
+        /*! \brief arm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        inline void establish( );
+
+        /*! \brief disarm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         *   std::logic_error : major programming error
+         */
+        inline void revoke( );
+
+        //! get number of events dropped because the queue was full
+        inline std::uint64_t get_dropped( ) const noexcept;
+
+        //! get number of handler function calls
+        inline std::uint64_t get_batches( ) const noexcept;
+
+        /*! \brief set affinity and scheduling of the dispatcher thread
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        inline void configure_dispatcher(const SignalThreadConfig &config);
+
+        //! copying not allowed
+        BatchSignalHandler(const BatchSignalHandler &other) = delete;
+        //! copying not allowed
+        BatchSignalHandler& operator=(const BatchSignalHandler &other) = delete;
+};
+
+inline void BatchSignalHandler::establish( )
+{
+    signal_handler.establish( );
+}
+
+inline void BatchSignalHandler::revoke( )
+{
+    signal_handler.revoke( );
+}
+
+inline std::uint64_t BatchSignalHandler::get_dropped( ) const noexcept
+{
+    return queue.get_dropped( );
+}
+
+inline std::uint64_t BatchSignalHandler::get_batches( ) const noexcept
+{
+    return batches.load(std::memory_order_relaxed);
+}
+
+inline void BatchSignalHandler::configure_dispatcher(const SignalThreadConfig &config)
+{
+    config.apply(dispatcher.native_handle( ));
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,58 @@
+/*
+ * \file BiasedLock.cpp
+ * \brief Source file de::Koesling::Signal::BiasedLock
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "BiasedLock.hpp"
+#include <sched.h>
+#include <stdexcept>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+BiasedLock::BiasedLock(AsymmetricFence &fence, pthread_t owner) noexcept :
+        fence(fence),
+        owner(owner),
+        owner_locked(0),
+        revoked(false),
+        owner_uses_mutex(false)
+{
+}
+
+void BiasedLock::revoke( )
+{
+    std::lock_guard<std::mutex> guard(revoke_mutex);
+    if (revoked.load( )) return;
+
+    revoked.store(true, std::memory_order_relaxed);
+
+    // after the fence the owner sees the revoke flag, and its owner_locked store is visible
+    fence.heavy(owner);
+
+    // wait until the owner left its biased critical section
+    while (owner_locked.load(std::memory_order_acquire) != 0)
+        sched_yield( );
+}
+
+void BiasedLock::release_bias( )
+{
+    if (!pthread_equal(pthread_self( ), owner))
+        throw std::logic_error("BiasedLock: only the owner can release the bias.");
+
+    revoked.store(true, std::memory_order_release);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
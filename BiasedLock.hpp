@@ -0,0 +1,149 @@
+/*
+ * \file BiasedLock.hpp
+ * \brief Header file de::Koesling::Signal::BiasedLock
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "AsymmetricFence.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <pthread.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Lock that is biased towards one owner thread
+ *
+ * As long as the lock is biased, the owner thread locks and unlocks with
+ * plain stores and a compiler barrier (no atomic read-modify-write, no
+ * fence instruction). The first lock() of another thread revokes the bias:
+ * it sets the revoke flag and executes the heavy side of an asymmetric
+ * fence on the owner (signal, see AsymmetricFence). Afterwards it waits
+ * until the owner left its critical section. From then on all threads
+ * (including the owner) use a mutex.
+ *
+ * The owner must call release_bias() (or destroy the lock) before it
+ * terminates, if the lock can be used by other threads afterwards.
+ * Usable with std::lock_guard / std::unique_lock.
+ */
+class BiasedLock
+{
+    private:
+        //! fence used to revoke the bias
+        AsymmetricFence &fence;
+
+        //! owner of the bias
+        pthread_t owner;
+
+        //! owner is in a biased critical section (written by the owner only)
+        std::atomic<std::uint32_t> owner_locked;
+
+        //! bias is revoked
+        std::atomic<bool> revoked;
+
+        //! owner holds the mutex (accessed by the owner only)
+        bool owner_uses_mutex;
+
+        //! lock after revocation
+        std::mutex mutex;
+
+        //! serializes revocations
+        std::mutex revoke_mutex;
+
+        //! revoke bias (not owner)
+        void revoke( );
+
+    public:
+        /*! \brief create lock
+         *
+         * attributes:
+         *   fence: asymmetric fence used to revoke the bias (must outlive the lock)
+         *   owner: thread that owns the bias
+         */
+        explicit BiasedLock(AsymmetricFence &fence, pthread_t owner = pthread_self( )) noexcept;
+
+        /*! \brief acquire lock
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        inline void lock( );
+
+        //! release lock
+        inline void unlock( ) noexcept;
+
+        //! check if the lock is still biased
+        inline bool is_biased( ) const noexcept;
+
+        /*! \brief give up the bias (owner only, not while locked)
+         *
+         * possible_throws:
+         *   std::logic_error: not called by the owner
+         */
+        void release_bias( );
+
+        //! copying not allowed
+        BiasedLock(const BiasedLock &other) = delete;
+        //! copying not allowed
+        BiasedLock& operator=(const BiasedLock &other) = delete;
+};
+
+inline void BiasedLock::lock( )
+{
+    if (pthread_equal(pthread_self( ), owner))
+    {
+        if (!revoked.load(std::memory_order_relaxed))
+        {
+            owner_locked.store(1, std::memory_order_relaxed);
+            AsymmetricFence::light( );
+            if (!revoked.load(std::memory_order_relaxed)) return;
+
+            // revoked concurrently: the revoker waits for this store
+            owner_locked.store(0, std::memory_order_release);
+        }
+
+        mutex.lock( );
+        owner_uses_mutex = true;
+        return;
+    }
+
+    if (!revoked.load(std::memory_order_acquire)) revoke( );
+    mutex.lock( );
+}
+
+inline void BiasedLock::unlock( ) noexcept
+{
+    if (pthread_equal(pthread_self( ), owner))
+    {
+        if (!owner_uses_mutex)
+        {
+            owner_locked.store(0, std::memory_order_release);
+            return;
+        }
+        owner_uses_mutex = false;
+    }
+
+    mutex.unlock( );
+}
+
+inline bool BiasedLock::is_biased( ) const noexcept
+{
+    return !revoked.load(std::memory_order_relaxed);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,145 @@
+/*
+ * \file BusyPollSignalHandler.cpp
+ * \brief Source file de::Koesling::Signal::BusyPollSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "BusyPollSignalHandler.hpp"
+#include "Futex.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <sysexits.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! number of spin iterations between two clock reads
+static constexpr unsigned CLOCK_INTERVAL = 64;
+
+//! spin loop hint (reduces power and pipeline flushes while spinning)
+static inline void cpu_relax( ) noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause( );
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+BusyPollSignalHandler::BusyPollSignalHandler(int signal_number, std::uint64_t idle_ns, std::size_t queue_capacity,
+        int sa_flags, sigset_t *blocked_signals) :
+        signal_number(signal_number),
+        idle_ns(idle_ns),
+        queue(queue_capacity),
+        sequence(0),
+        parked(0),
+        spin_wakeups(0),
+        futex_wakeups(0),
+        signal_handler(signal_number, SignalTrampoline::handler, sa_flags, blocked_signals)
+{
+    SignalTrampoline::attach(signal_number, this);
+}
+
+BusyPollSignalHandler::~BusyPollSignalHandler( )
+{
+    // restore previous handler before the sink is detached
+    if (signal_handler.is_established( ))
+    {
+        try
+        {
+            signal_handler.revoke( );
+        }
+        catch (const std::exception &e) // system call failed
+        {
+            destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+        }
+    }
+
+    SignalTrampoline::detach(signal_number, this);
+}
+
+void BusyPollSignalHandler::on_signal(int, siginfo_t *info, void*) noexcept
+{
+    SignalEvent event;
+    to_signal_event(*info, monotonic_ns( ), event);
+    if (!queue.push(event)) return;
+
+    // seq_cst: pairs with parked.store in wait() (no lost wake up)
+    sequence.fetch_add(1);
+    if (parked.load( ) != 0) futex_wake(sequence, 1);
+}
+
+bool BusyPollSignalHandler::wait(SignalEvent &event, std::int64_t timeout_ns)
+{
+    const std::uint64_t start = monotonic_ns( );
+    const std::uint64_t deadline_ns = start + static_cast<std::uint64_t>(timeout_ns);
+
+    // spin phase
+    std::uint64_t now = start;
+    for (unsigned i = 1; ; ++i)
+    {
+        if (queue.pop(event))
+        {
+            spin_wakeups.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        cpu_relax( );
+
+        if (i % CLOCK_INTERVAL == 0)
+        {
+            now = monotonic_ns( );
+            if (timeout_ns >= 0 && now >= deadline_ns) return false;
+            if (now - start >= idle_ns) break;
+        }
+    }
+
+    // park phase: absolute deadline, retries wait for the remaining time only
+    struct timespec deadline;
+    if (timeout_ns >= 0)
+    {
+        deadline.tv_sec = static_cast<time_t>(deadline_ns / 1000000000u);
+        deadline.tv_nsec = static_cast<long>(deadline_ns % 1000000000u);
+    }
+
+    parked.store(1);
+    for (;;)
+    {
+        const std::uint32_t seen = sequence.load( );
+        if (queue.pop(event))
+        {
+            parked.store(0, std::memory_order_relaxed);
+            futex_wakeups.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        long temp = futex_wait(sequence, seen, timeout_ns >= 0 ? &deadline : nullptr);
+        if (temp == -1 && errno == ETIMEDOUT)
+        {
+            parked.store(0, std::memory_order_relaxed);
+            return queue.pop(event);
+        }
+        if (temp == -1 && errno != EAGAIN && errno != EINTR)
+        {
+            int error = errno;
+            parked.store(0, std::memory_order_relaxed);
+            sysexcept(true, "futex", error);
+        }
+    }
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,167 @@
+/*
+ * \file BusyPollSignalHandler.hpp
+ * \brief Header file de::Koesling::Signal::BusyPollSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalEvent.hpp"
+#include "SignalEventQueue.hpp"
+#include "SignalHandler.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Signal handler for a busy polling consumer thread
+ *
+ * The installed trampoline publishes the siginfo_t into a lock free queue.
+ * The consumer (usually a thread on an isolated cpu) spins on the queue
+ * (with a cpu relax hint) instead of sleeping. This avoids the scheduler
+ * wake up latency. After idle_ns without events the consumer parks on a
+ * futex. The trampoline only performs the futex wake up if the consumer is
+ * parked.
+ *
+ * Only one thread may call wait() / try_pop() at a time.
+ */
+class BusyPollSignalHandler : private SignalSink
+{
+    private:
+        //! signal number
+        int signal_number;
+
+        //! spin time before the consumer parks
+        std::uint64_t idle_ns;
+
+        //! events captured by the trampoline
+        SignalEventQueue queue;
+
+        //! number of published events (futex word)
+        alignas(64) std::atomic<std::uint32_t> sequence;
+
+        //! consumer is (about to be) parked on the futex
+        alignas(64) std::atomic<std::uint32_t> parked;
+
+        //! statistics (consumer)
+        alignas(64) std::atomic<std::uint64_t> spin_wakeups;
+        std::atomic<std::uint64_t> futex_wakeups;
+
+        //! installed trampoline
+        SignalHandler signal_handler;
+
+        //! publish event (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+    public:
+        /*! \brief init BusyPollSignalHandler
+         *
+         * attributes:
+         *   signal_number  : signal which will be handled by this handler
+         *   idle_ns        : spin time without events before the consumer
+         *                    parks on a futex
+         *   queue_capacity : maximum number of events that are not yet
+         *                    consumed (further events are dropped)
+         *   sa_flags       : see man sigaction (sa_flags)
+         *   blocked_signals: see man sigaction (sa_mask)
+         * possible_throws:
+         *   std::invalid_argument: invalid argument
+         *   std::logic_error     : another sink is attached to the signal
+         */
+        BusyPollSignalHandler(int signal_number, std::uint64_t idle_ns = 100000, std::size_t queue_capacity = 1024,
+                int sa_flags = SA_RESTART, sigset_t *blocked_signals = nullptr);
+
+        //! revoke handler
+        ~BusyPollSignalHandler( );
+
+        /*! \brief arm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        inline void establish( );
+
+        /*! \brief disarm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         *   std::logic_error : major programming error
+         */
+        inline void revoke( );
+
+        //! get next event without waiting (returns false if there is none)
+        inline bool try_pop(SignalEvent &event) noexcept;
+
+        /*! \brief wait for the next event
+         *
+         * Spins for idle_ns, then parks on a futex.
+         *
+         * attributes:
+         *   event     : received event
+         *   timeout_ns: timeout (negative: no timeout)
+         * returns false on timeout
+         *
+         * possible_throws:
+         *   std::system_error: futex system call failed
+         */
+        bool wait(SignalEvent &event, std::int64_t timeout_ns = -1);
+
+        //! get number of events dropped because the queue was full
+        inline std::uint64_t get_dropped( ) const noexcept;
+
+        //! get number of events received while spinning
+        inline std::uint64_t get_spin_wakeups( ) const noexcept;
+
+        //! get number of events received after parking on the futex
+        inline std::uint64_t get_futex_wakeups( ) const noexcept;
+
+        //! copying not allowed
+        BusyPollSignalHandler(const BusyPollSignalHandler &other) = delete;
+        //! copying not allowed
+        BusyPollSignalHandler& operator=(const BusyPollSignalHandler &other) = delete;
+};
+
+inline void BusyPollSignalHandler::establish( )
+{
+    signal_handler.establish( );
+}
+
+inline void BusyPollSignalHandler::revoke( )
+{
+    signal_handler.revoke( );
+}
+
+inline bool BusyPollSignalHandler::try_pop(SignalEvent &event) noexcept
+{
+    return queue.pop(event);
+}
+
+inline std::uint64_t BusyPollSignalHandler::get_dropped( ) const noexcept
+{
+    return queue.get_dropped( );
+}
+
+inline std::uint64_t BusyPollSignalHandler::get_spin_wakeups( ) const noexcept
+{
+    return spin_wakeups.load(std::memory_order_relaxed);
+}
+
+inline std::uint64_t BusyPollSignalHandler::get_futex_wakeups( ) const noexcept
+{
+    return futex_wakeups.load(std::memory_order_relaxed);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,142 @@
+/*
+ * \file Cancellation.cpp
+ * \brief Source file de::Koesling::Signal::Cancellation
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "Cancellation.hpp"
+#include "RealtimeSignals.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <sys/syscall.h>
+#include <sysexits.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+Cancellation::Cancellation( ) :
+        signal_number(RealtimeSignals::reserve( )),
+        signal_handler(signal_number, handler, 0)	// no SA_RESTART: interrupt blocking system calls
+{
+    try
+    {
+        signal_handler.establish( );
+    }
+    catch (...)
+    {
+        RealtimeSignals::release(signal_number);
+        throw;
+    }
+}
+
+Cancellation::~Cancellation( )
+{
+    try
+    {
+        signal_handler.revoke( );
+    }
+    catch (const std::exception &e) // system call failed
+    {
+        destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+    }
+    RealtimeSignals::release(signal_number);
+}
+
+Cancellation::State& Cancellation::state( ) noexcept
+{
+    static thread_local State thread_state { { false }, 0, 0, { } };
+    if (thread_state.thread == 0) thread_state.thread = static_cast<pid_t>(syscall(SYS_gettid));
+    return thread_state;
+}
+
+Cancellation::Target Cancellation::current( ) noexcept
+{
+    return Target { pthread_self( ), &state( ) };
+}
+
+void Cancellation::cancel(const Target &target)
+{
+    target.state->cancelled.store(true);
+
+    // the signal carries the state: no thread local lookup in the handler
+    union sigval value;
+    value.sival_ptr = target.state;
+
+    // pthread_sigqueue does not use errno
+    int temp = pthread_sigqueue(target.thread, signal_number, value);
+    sysexcept(temp != 0, "pthread_sigqueue", temp);
+}
+
+void Cancellation::handler(int, siginfo_t *info, void*)
+{
+    // only accept requests of this process
+    if (info->si_code != SI_QUEUE || info->si_pid != getpid( )) return;
+
+    State *target = static_cast<State*>(info->si_value.sival_ptr);
+    if (target->thread != static_cast<pid_t>(syscall(SYS_gettid))) return;
+
+    target->cancelled.store(true);
+
+    if (target->hard)
+    {
+        target->hard = 0;
+        siglongjmp(target->jump_buffer, 1);
+    }
+}
+
+bool Cancellation::is_cancelled( ) noexcept
+{
+    return state( ).cancelled.load(std::memory_order_relaxed);
+}
+
+void Cancellation::checkpoint( )
+{
+    if (is_cancelled( )) throw cancelled_error( );
+}
+
+void Cancellation::reset( ) noexcept
+{
+    state( ).cancelled.store(false);
+}
+
+bool Cancellation::run_hard(void (*function)(void*), void *argument)
+{
+    State &thread_state = state( );
+    if (thread_state.hard) throw std::logic_error("Nested hard cancellation regions are not allowed.");
+
+    if (thread_state.cancelled.load( )) return false;
+
+    // save signal mask: siglongjmp leaves the handler with the signal blocked otherwise
+    if (sigsetjmp(thread_state.jump_buffer, 1) != 0) return false;	// cancelled
+
+    thread_state.hard = 1;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    // cancellation between the check above and setting hard
+    if (thread_state.cancelled.load( ))
+    {
+        thread_state.hard = 0;
+        return false;
+    }
+
+    function(argument);
+
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    thread_state.hard = 0;
+    return true;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
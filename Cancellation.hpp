@@ -0,0 +1,153 @@
+/*
+ * \file Cancellation.hpp
+ * \brief Header file de::Koesling::Signal::Cancellation
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalHandler.hpp"
+#include <atomic>
+#include <csetjmp>
+#include <pthread.h>
+#include <stdexcept>
+#include <sys/types.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! thrown by Cancellation::checkpoint() if the calling thread is cancelled
+class cancelled_error : public std::runtime_error
+{
+    public:
+        cancelled_error( ) :
+                std::runtime_error("operation cancelled")
+        { }
+};
+
+/*! \brief Asynchronous cancellation of threads via signals
+ *
+ * cancel() sends a reserved realtime signal to the target thread. The
+ * handler sets the cancellation token of the thread, which is observed at
+ * cooperative checkpoints (is_cancelled(), checkpoint()).
+ * The signal is installed without SA_RESTART: blocking system calls of the
+ * target thread are interrupted and fail with EINTR (the wrappers of
+ * InterruptibleIo do not retry calls of cancelled threads). A cancellation
+ * that arrives before the thread blocks in a system call does not
+ * interrupt it: the token is observed after the call returns.
+ *
+ * Hard mode: code executed by run_hard() is left immediately via
+ * siglongjmp if the thread is cancelled. Such code must not own resources
+ * that need cleanup (no objects with non-trivial destructors, no locks, no
+ * heap allocations, no non-async-signal-safe functions).
+ */
+class Cancellation
+{
+    public:
+        //! cancellation state of a thread
+        struct State
+        {
+            //! cancellation requested
+            std::atomic<bool> cancelled;
+            //! kernel thread id of the owner
+            pid_t thread;
+            //! thread is inside run_hard()
+            volatile sig_atomic_t hard;
+            //! jump target of run_hard()
+            sigjmp_buf jump_buffer;
+        };
+
+        //! cancellation target (obtained by the target thread via current())
+        struct Target
+        {
+            pthread_t thread;
+            State *state;
+        };
+
+    private:
+        //! reserved realtime signal
+        int signal_number;
+
+        //! installed handler (without SA_RESTART)
+        SignalHandler signal_handler;
+
+        //! signal handler function (SignalHandler_extended_t)
+        static void handler(int signal_number, siginfo_t *info, void *context);
+
+        //! get state of the calling thread
+        static State& state( ) noexcept;
+
+    public:
+        /*! \brief reserve signal and install handler
+         *
+         * possible_throws:
+         *   std::runtime_error: no free realtime signal
+         *   std::system_error : a system call failed
+         */
+        Cancellation( );
+
+        //! revoke handler and release signal
+        ~Cancellation( );
+
+        //! get cancellation target of the calling thread
+        static Target current( ) noexcept;
+
+        /*! \brief cancel target thread
+         *
+         * The target thread must still exist.
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        void cancel(const Target &target);
+
+        //! check if the calling thread is cancelled
+        static bool is_cancelled( ) noexcept;
+
+        /*! \brief cooperative checkpoint
+         *
+         * possible_throws:
+         *   cancelled_error: the calling thread is cancelled
+         */
+        static void checkpoint( );
+
+        //! reset the cancellation token of the calling thread
+        static void reset( ) noexcept;
+
+        /*! \brief execute function in hard cancellation mode
+         *
+         * Returns false if the function was left due to cancellation.
+         * Nesting is not allowed.
+         *
+         * possible_throws:
+         *   std::logic_error: nested call
+         */
+        static bool run_hard(void (*function)(void*), void *argument);
+
+        //! get the reserved signal
+        inline int get_signal_number( ) const noexcept;
+
+        //! copying not allowed
+        Cancellation(const Cancellation &other) = delete;
+        //! copying not allowed
+        Cancellation& operator=(const Cancellation &other) = delete;
+};
+
+inline int Cancellation::get_signal_number( ) const noexcept
+{
+    return signal_number;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,65 @@
+/*
+ * \file DeliveryCounter.cpp
+ * \brief Source file de::Koesling::Signal::DeliveryCounter
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "DeliveryCounter.hpp"
+#include <memory>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+InnerHandler DeliveryCounter::handlers[_NSIG];
+std::atomic<PerCpuCounter*> DeliveryCounter::counters[_NSIG];
+
+void DeliveryCounter::prepare(int signal_number)
+{
+    if (counters[signal_number].load( ) != nullptr) return;
+
+    std::unique_ptr<PerCpuCounter> counter(new PerCpuCounter( ));
+    PerCpuCounter *expected = nullptr;
+    if (counters[signal_number].compare_exchange_strong(expected, counter.get( ))) counter.release( );
+}
+
+void DeliveryCounter::exchange(int signal_number, const struct sigaction &inner, struct sigaction &old_inner) noexcept
+{
+    handlers[signal_number].exchange(inner, old_inner);
+}
+
+void DeliveryCounter::handler(int signal_number, siginfo_t *info, void *context)
+{
+    PerCpuCounter *counter = counters[signal_number].load(std::memory_order_acquire);
+    if (counter != nullptr) counter->add( );
+
+    handlers[signal_number].call(signal_number, info, context);
+}
+
+std::uint64_t DeliveryCounter::get_count(int signal_number) noexcept
+{
+    if (signal_number < SIGHUP || signal_number >= _NSIG) return 0;
+
+    PerCpuCounter *counter = counters[signal_number].load( );
+    return counter != nullptr ? counter->get( ) : 0;
+}
+
+void DeliveryCounter::reset(int signal_number) noexcept
+{
+    if (signal_number < SIGHUP || signal_number >= _NSIG) return;
+
+    PerCpuCounter *counter = counters[signal_number].load( );
+    if (counter != nullptr) counter->reset( );
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,74 @@
+/*
+ * \file DeliveryCounter.hpp
+ * \brief Header file de::Koesling::Signal::DeliveryCounter
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "InnerHandler.hpp"
+#include "PerCpuCounter.hpp"
+#include <atomic>
+#include <csignal>
+#include <cstdint>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Count signal deliveries
+ *
+ * Enabled per SignalHandler by SignalHandler::enable_counting().
+ * The handler is then invoked by a counting trampoline that increments a
+ * PerCpuCounter of the signal (a single non-atomic add on the delivery path
+ * if restartable sequences are available). The counters are summed only by
+ * get_count().
+ */
+class DeliveryCounter
+{
+    private:
+        //! counted handler function per signal
+        static InnerHandler handlers[_NSIG];
+
+        //! delivery counter per signal (created by prepare(), never released)
+        static std::atomic<PerCpuCounter*> counters[_NSIG];
+
+    public:
+        DeliveryCounter( ) = delete;
+
+        /*! \brief create the counter of a signal (used by SignalHandler)
+         *
+         * possible_throws:
+         *   std::bad_alloc: out of memory
+         */
+        static void prepare(int signal_number);
+
+        /*! \brief set the counted handler of a signal (used by SignalHandler)
+         *
+         * inner.sa_handler / inner.sa_sigaction (selected by SA_SIGINFO) is
+         * called by the counting trampoline. The previous handler is stored
+         * in old_inner.
+         */
+        static void exchange(int signal_number, const struct sigaction &inner, struct sigaction &old_inner) noexcept;
+
+        //! counting trampoline (SignalHandler_extended_t)
+        static void handler(int signal_number, siginfo_t *info, void *context);
+
+        //! get number of counted deliveries of a signal
+        static std::uint64_t get_count(int signal_number) noexcept;
+
+        //! reset delivery counter of a signal
+        static void reset(int signal_number) noexcept;
+};
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
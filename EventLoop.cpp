@@ -0,0 +1,361 @@
+/*
+ * \file EventLoop.cpp
+ * \brief Source file de::Koesling::Signal::EventLoop
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * requires linux 5.11 or higher for epoll_pwait2 (falls back to epoll_pwait)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "EventLoop.hpp"
+#include "RealtimeSignals.hpp"
+#include "SignalRegistry.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <sysexits.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! maximum number of events per wait
+static constexpr int MAX_EVENTS = 64;
+
+//! kernel thread id of the calling thread (cached)
+static pid_t current_thread( ) noexcept
+{
+    static thread_local pid_t thread = 0;
+    if (thread == 0) thread = static_cast<pid_t>(syscall(SYS_gettid));
+    return thread;
+}
+
+EventLoop::EventLoop( ) :
+        epoll_fd(-1),
+        wakeup_fd(-1),
+        stop_requested(false),
+        signals_adopted(false),
+        loop_thread(0),
+#ifdef SYS_epoll_pwait2
+        use_epoll_pwait(false)
+#else
+        use_epoll_pwait(true)
+#endif
+{
+    sigemptyset(&loop_signals);
+    sigemptyset(&wait_mask);
+    sigemptyset(&blocked_signals);
+    for (auto &flag : pending)
+        flag.store(false, std::memory_order_relaxed);
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    sysexcept(epoll_fd == -1, "epoll_create1", errno);
+
+    wakeup_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeup_fd == -1)
+    {
+        int error = errno;
+        close(epoll_fd);
+        sysexcept(true, "eventfd", error);
+    }
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = wakeup_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &event) != 0)
+    {
+        int error = errno;
+        close(wakeup_fd);
+        close(epoll_fd);
+        sysexcept(true, "epoll_ctl", error);
+    }
+}
+
+EventLoop::~EventLoop( )
+{
+    // unblock before the handlers are revoked: pending signals still reach the flag handler
+    pthread_sigmask(SIG_UNBLOCK, &blocked_signals, nullptr);
+
+    for (auto &handler : signal_handlers)
+    {
+        const int signal_number = handler.get_signal_number( );
+        try
+        {
+            handler.revoke( );
+        }
+        catch (const std::exception &e) // system call failed
+        {
+            destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+        }
+        SignalTrampoline::detach(signal_number, this);
+    }
+
+    for (auto &timer : timer_callbacks)
+        close(timer.first);
+
+    close(wakeup_fd);
+    close(epoll_fd);
+}
+
+void EventLoop::add_fd(int fd, std::uint32_t events, FdCallback_t callback)
+{
+    epoll_event event;
+    event.events = events;
+    event.data.fd = fd;
+    int temp = epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    sysexcept(temp != 0, "epoll_ctl", errno);
+
+    fd_callbacks[fd] = std::make_shared<FdCallback_t>(std::move(callback));
+}
+
+void EventLoop::modify_fd(int fd, std::uint32_t events)
+{
+    epoll_event event;
+    event.events = events;
+    event.data.fd = fd;
+    int temp = epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+    sysexcept(temp != 0, "epoll_ctl", errno);
+}
+
+void EventLoop::remove_fd(int fd) noexcept
+{
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    fd_callbacks.erase(fd);
+}
+
+int EventLoop::add_timer(std::chrono::nanoseconds initial, std::chrono::nanoseconds interval,
+        TimerCallback_t callback)
+{
+    int timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    sysexcept(timer_fd == -1, "timerfd_create", errno);
+
+    // an all zero it_value disarms the timer
+    if (initial.count( ) <= 0) initial = std::chrono::nanoseconds(1);
+
+    itimerspec spec;
+    spec.it_value.tv_sec = static_cast<time_t>(initial.count( ) / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(initial.count( ) % 1000000000);
+    spec.it_interval.tv_sec = static_cast<time_t>(interval.count( ) / 1000000000);
+    spec.it_interval.tv_nsec = static_cast<long>(interval.count( ) % 1000000000);
+
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = timer_fd;
+
+    if (timerfd_settime(timer_fd, 0, &spec, nullptr) != 0 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &event) != 0)
+    {
+        int error = errno;
+        close(timer_fd);
+        sysexcept(true, "timerfd", error);
+    }
+
+    timer_callbacks[timer_fd] = std::make_shared<TimerCallback_t>(std::move(callback));
+    return timer_fd;
+}
+
+void EventLoop::remove_timer(int timer_id) noexcept
+{
+    if (timer_callbacks.erase(timer_id) == 0) return;
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, timer_id, nullptr);
+    close(timer_id);
+}
+
+void EventLoop::add_signal(int signal_number, SignalCallback_t callback, int sa_flags)
+{
+    SignalHandler handler(signal_number, SignalTrampoline::handler, sa_flags);
+
+    // state of the signal before it is adopted
+    const bool adopted = sigismember(&loop_signals, signal_number) == 1;
+    sigset_t old_mask;
+    pthread_sigmask(SIG_SETMASK, nullptr, &old_mask);
+
+    SignalTrampoline::attach(signal_number, this);
+    try
+    {
+        adopt_signal(signal_number);
+        handler.establish( );
+        signal_handlers.push_back(std::move(handler));
+    }
+    catch (...)
+    {
+        if (!adopted) sigdelset(&loop_signals, signal_number);
+        if (sigismember(&old_mask, signal_number) == 0)
+        {
+            sigset_t signals;
+            sigemptyset(&signals);
+            sigaddset(&signals, signal_number);
+            pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+            sigdelset(&blocked_signals, signal_number);
+        }
+        update_wait_mask(old_mask);
+        SignalTrampoline::detach(signal_number, this);
+        throw;
+    }
+
+    signal_callbacks[signal_number] = std::make_shared<SignalCallback_t>(std::move(callback));
+}
+
+void EventLoop::adopt_signal(int signal_number)
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, signal_number);
+
+    // pthread_sigmask does not use errno
+    sigset_t old_mask;
+    int temp = pthread_sigmask(SIG_BLOCK, &signals, &old_mask);
+    sysexcept(temp != 0, "pthread_sigmask", temp);
+
+    if (sigismember(&old_mask, signal_number) == 0) sigaddset(&blocked_signals, signal_number);
+    sigaddset(&loop_signals, signal_number);
+    update_wait_mask(old_mask);
+}
+
+void EventLoop::update_wait_mask(const sigset_t &thread_mask) noexcept
+{
+    // computed once per adoption: the wait does not query the mask
+    wait_mask = thread_mask;
+    signals_adopted = false;
+    for (int i = SIGHUP; i < _NSIG; ++i)
+    {
+        if (sigismember(&loop_signals, i) != 1) continue;
+        sigdelset(&wait_mask, i);
+        signals_adopted = true;
+    }
+}
+
+void EventLoop::adopt_handled_signals( )
+{
+    for (int i = SIGHUP; i < _NSIG; ++i)
+        if (SignalRegistry::is_handled(i) && !SignalRegistry::is_synchronous(i) && !RealtimeSignals::is_reserved(i))
+            adopt_signal(i);
+}
+
+void EventLoop::on_signal(int signal_number, siginfo_t*, void*) noexcept
+{
+    pending[signal_number].store(true, std::memory_order_release);
+
+    // handled by another thread --> the loop thread may not be waiting
+    if (static_cast<pid_t>(syscall(SYS_gettid)) != loop_thread.load(std::memory_order_relaxed))
+    {
+        const int saved_errno = errno;
+        std::uint64_t value = 1;
+        static_cast<void>(write(wakeup_fd, &value, sizeof(value)));
+        errno = saved_errno;
+    }
+}
+
+int EventLoop::wait(struct epoll_event *events, int max_events, std::chrono::nanoseconds timeout)
+{
+    // no loop signals: keep the current mask
+    const sigset_t *mask = signals_adopted ? &wait_mask : nullptr;
+
+#ifdef SYS_epoll_pwait2
+    if (!use_epoll_pwait)
+    {
+        struct timespec spec;
+        spec.tv_sec = static_cast<time_t>(timeout.count( ) / 1000000000);
+        spec.tv_nsec = static_cast<long>(timeout.count( ) % 1000000000);
+
+        long temp = syscall(SYS_epoll_pwait2, epoll_fd, events, max_events, timeout.count( ) < 0 ? nullptr : &spec,
+                mask, _NSIG / 8);
+        if (temp != -1 || errno != ENOSYS) return static_cast<int>(temp);
+
+        use_epoll_pwait = true;
+    }
+#endif
+
+    // millisecond resolution (round up)
+    const int timeout_ms = timeout.count( ) < 0 ? -1 : static_cast<int>((timeout.count( ) + 999999) / 1000000);
+    return epoll_pwait(epoll_fd, events, max_events, timeout_ms, mask);
+}
+
+std::size_t EventLoop::run_once(std::chrono::nanoseconds timeout)
+{
+    loop_thread.store(current_thread( ), std::memory_order_relaxed);
+
+    epoll_event events[MAX_EVENTS];
+    int count = wait(events, MAX_EVENTS, timeout);
+    if (count == -1)
+    {
+        sysexcept(errno != EINTR, "epoll_pwait", errno);
+        count = 0;	// interrupted by a signal: dispatch signal callbacks
+    }
+
+    std::size_t dispatched = 0;
+
+    // signals
+    for (auto it = signal_callbacks.begin( ); it != signal_callbacks.end( ); ++it)
+    {
+        if (!pending[it->first].exchange(false, std::memory_order_acquire)) continue;
+        std::shared_ptr<SignalCallback_t> callback = it->second;
+        (*callback)(it->first);
+        ++dispatched;
+    }
+
+    // file descriptors and timers
+    for (int i = 0; i < count; ++i)
+    {
+        const int fd = events[i].data.fd;
+
+        if (fd == wakeup_fd)
+        {
+            std::uint64_t value;
+            static_cast<void>(read(wakeup_fd, &value, sizeof(value)));
+            continue;
+        }
+
+        auto timer = timer_callbacks.find(fd);
+        if (timer != timer_callbacks.end( ))
+        {
+            std::uint64_t expirations = 0;
+            if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) continue;
+            std::shared_ptr<TimerCallback_t> callback = timer->second;
+            (*callback)(expirations);
+            ++dispatched;
+            continue;
+        }
+
+        auto watched = fd_callbacks.find(fd);
+        if (watched != fd_callbacks.end( ))
+        {
+            std::shared_ptr<FdCallback_t> callback = watched->second;
+            (*callback)(events[i].events);
+            ++dispatched;
+        }
+    }
+
+    return dispatched;
+}
+
+void EventLoop::run( )
+{
+    stop_requested.store(false);
+    while (!stop_requested.load( ))
+        run_once( );
+}
+
+void EventLoop::stop( ) noexcept
+{
+    stop_requested.store(true);
+    std::uint64_t value = 1;
+    static_cast<void>(write(wakeup_fd, &value, sizeof(value)));
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,225 @@
+/*
+ * \file EventLoop.hpp
+ * \brief Header file de::Koesling::Signal::EventLoop
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * requires linux 5.11 or higher for epoll_pwait2 (falls back to epoll_pwait)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalHandler.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sys/epoll.h>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Minimal epoll event loop with atomic signal unmasking
+ *
+ * The signals of the loop are blocked in the loop thread except during
+ * epoll_pwait2 (the mask is changed atomically by the kernel). Signal
+ * handlers therefore only run in the loop thread while the loop waits. The
+ * handlers installed by add_signal() just set a flag, the callbacks run
+ * afterwards in normal thread context. No self-pipe write is required for
+ * signals delivered to the loop thread.
+ *
+ * In multithreaded programs another thread that does not block the signal
+ * may run the flag handler while the loop thread is busy. In this case the
+ * handler wakes up the loop via its eventfd, so the signal is dispatched by
+ * the next run_once() without waiting for the timeout.
+ *
+ * All functions except stop() must be called by the loop thread.
+ */
+class EventLoop : private SignalSink
+{
+    public:
+        //! fd callback (argument: epoll events)
+        typedef std::function<void(std::uint32_t)> FdCallback_t;
+        //! timer callback (argument: number of expirations)
+        typedef std::function<void(std::uint64_t)> TimerCallback_t;
+        //! signal callback (argument: signal number)
+        typedef std::function<void(int)> SignalCallback_t;
+
+    private:
+        //! epoll instance
+        int epoll_fd;
+
+        //! eventfd used by stop()
+        int wakeup_fd;
+
+        //! stop requested
+        std::atomic<bool> stop_requested;
+
+        //! signals unblocked only during the wait
+        sigset_t loop_signals;
+
+        //! signal mask during the wait (thread mask without the loop signals, valid if signals_adopted)
+        sigset_t wait_mask;
+
+        //! loop_signals is not empty
+        bool signals_adopted;
+
+        //! loop signals that were not blocked before they were adopted (unblocked by the destructor)
+        sigset_t blocked_signals;
+
+        //! fd callbacks
+        std::map<int, std::shared_ptr<FdCallback_t>> fd_callbacks;
+
+        //! timer callbacks (by timerfd)
+        std::map<int, std::shared_ptr<TimerCallback_t>> timer_callbacks;
+
+        //! signal callbacks
+        std::map<int, std::shared_ptr<SignalCallback_t>> signal_callbacks;
+
+        //! installed flag handlers
+        std::vector<SignalHandler> signal_handlers;
+
+        //! pending signals (set by the flag handler)
+        std::atomic<bool> pending[_NSIG];
+
+        //! kernel thread id of the thread that runs the loop (0: not running yet)
+        std::atomic<pid_t> loop_thread;
+
+        //! epoll_pwait2 is not supported by the kernel
+        bool use_epoll_pwait;
+
+        //! set pending flag (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+        //! compute wait_mask from the signal mask of the loop thread
+        void update_wait_mask(const sigset_t &thread_mask) noexcept;
+
+        //! wait for events (timeout < 0: infinite)
+        int wait(struct epoll_event *events, int max_events, std::chrono::nanoseconds timeout);
+
+    public:
+        /*! \brief create event loop
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        EventLoop( );
+
+        /*! \brief close event loop
+         *
+         * Unblocks the signals that were blocked by add_signal() or
+         * adopt_signal() (not those that were already blocked before) and
+         * revokes the signal handlers. Must be called by the loop thread.
+         */
+        ~EventLoop( );
+
+        /*! \brief watch file descriptor
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        void add_fd(int fd, std::uint32_t events, FdCallback_t callback);
+
+        /*! \brief change watched events of a file descriptor
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        void modify_fd(int fd, std::uint32_t events);
+
+        //! stop watching file descriptor
+        void remove_fd(int fd) noexcept;
+
+        /*! \brief add timer (timerfd, CLOCK_MONOTONIC)
+         *
+         * attributes:
+         *   initial : time until the first expiration
+         *   interval: period (0: one shot)
+         * returns timer id
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        int add_timer(std::chrono::nanoseconds initial, std::chrono::nanoseconds interval, TimerCallback_t callback);
+
+        //! remove timer
+        void remove_timer(int timer_id) noexcept;
+
+        /*! \brief handle signal in the loop
+         *
+         * Installs a flag handler for the signal and blocks the signal in the
+         * calling thread. The callback is executed by the loop after the
+         * signal was delivered during the wait.
+         *
+         * possible_throws:
+         *   std::invalid_argument: invalid signal number
+         *   std::logic_error     : signal already handled by another sink
+         *   std::system_error    : a system call failed
+         */
+        void add_signal(int signal_number, SignalCallback_t callback, int sa_flags = SA_RESTART);
+
+        /*! \brief unblock signal only during the wait
+         *
+         * For signals with handlers that are installed elsewhere (e.g. by a
+         * SignalHandler object): the handler only runs while the loop waits.
+         * The signal mask during the wait is computed here (the mask of the
+         * loop thread without the loop signals): later changes of the mask
+         * of the loop thread are not applied to the wait.
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        void adopt_signal(int signal_number);
+
+        /*! \brief adopt all signals handled by established SignalHandler objects
+         *
+         * Synchronous fault signals and the realtime signals reserved by this
+         * library (see RealtimeSignals) are not adopted.
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        void adopt_handled_signals( );
+
+        /*! \brief wait for events once and dispatch them
+         *
+         * timeout < 0: wait infinitely
+         * returns the number of dispatched events
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        std::size_t run_once(std::chrono::nanoseconds timeout = std::chrono::nanoseconds(-1));
+
+        /*! \brief run until stop() is called
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        void run( );
+
+        //! stop run() (thread safe, async-signal-safe)
+        void stop( ) noexcept;
+
+        //! copying not allowed
+        EventLoop(const EventLoop &other) = delete;
+        //! copying not allowed
+        EventLoop& operator=(const EventLoop &other) = delete;
+};
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
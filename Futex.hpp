@@ -0,0 +1,62 @@
+/*
+ * \file Futex.hpp
+ * \brief Header file de::Koesling::Signal futex helpers
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be a plain 32 bit value.");
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! raw futex system call (no libc wrapper available)
+inline long futex(std::atomic<std::uint32_t> &word, int operation, std::uint32_t value,
+        const struct timespec *timeout, std::uint32_t value3) noexcept
+{
+    return syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), operation, value, timeout, nullptr, value3);
+}
+
+/*! \brief wake up to count threads waiting on word
+ *
+ * async-signal-safe
+ * returns the number of woken threads or -1 (errno)
+ */
+inline long futex_wake(std::atomic<std::uint32_t> &word, int count = INT_MAX) noexcept
+{
+    return futex(word, FUTEX_WAKE_PRIVATE, static_cast<std::uint32_t>(count), nullptr, 0);
+}
+
+/*! \brief wait until woken if word contains expected
+ *
+ * deadline: absolute CLOCK_MONOTONIC time (nullptr: no timeout)
+ * returns 0 or -1 (errno: EAGAIN (value changed), ETIMEDOUT, EINTR)
+ */
+inline long futex_wait(std::atomic<std::uint32_t> &word, std::uint32_t expected,
+        const struct timespec *deadline = nullptr) noexcept
+{
+    // FUTEX_WAIT_BITSET uses an absolute timeout: retries keep the original deadline
+    return futex(word, FUTEX_WAIT_BITSET_PRIVATE, expected, deadline, FUTEX_BITSET_MATCH_ANY);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,97 @@
+/*
+ * \file FutexSignalHandler.cpp
+ * \brief Source file de::Koesling::Signal::FutexSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "FutexSignalHandler.hpp"
+#include "Futex.hpp"
+#include "SignalEvent.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <sysexits.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+FutexSignalHandler::FutexSignalHandler(int signal_number, int sa_flags, sigset_t *blocked_signals) :
+        signal_number(signal_number),
+        sequence(0),
+        waiters(0),
+        signal_handler(signal_number, SignalTrampoline::handler, sa_flags, blocked_signals)
+{
+    SignalTrampoline::attach(signal_number, this);
+}
+
+FutexSignalHandler::~FutexSignalHandler( )
+{
+    // restore previous handler before the sink is detached
+    if (signal_handler.is_established( ))
+    {
+        try
+        {
+            signal_handler.revoke( );
+        }
+        catch (const std::exception &e) // system call failed
+        {
+            destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+        }
+    }
+
+    SignalTrampoline::detach(signal_number, this);
+}
+
+void FutexSignalHandler::on_signal(int, siginfo_t*, void*) noexcept
+{
+    // seq_cst: pairs with the waiters increment in wait() (no lost wake up)
+    sequence.fetch_add(1);
+    if (waiters.load( ) != 0) futex_wake(sequence);
+}
+
+std::uint32_t FutexSignalHandler::wait(std::uint32_t last, std::int64_t timeout_ns)
+{
+    std::uint32_t current = sequence.load(std::memory_order_acquire);
+    if (current != last) return current;
+
+    // absolute deadline: retries wait for the remaining time only
+    struct timespec deadline;
+    if (timeout_ns >= 0)
+    {
+        const std::uint64_t end = monotonic_ns( ) + static_cast<std::uint64_t>(timeout_ns);
+        deadline.tv_sec = static_cast<time_t>(end / 1000000000u);
+        deadline.tv_nsec = static_cast<long>(end % 1000000000u);
+    }
+
+    waiters.fetch_add(1);
+    for (;;)
+    {
+        current = sequence.load( );
+        if (current != last) break;
+
+        long temp = futex_wait(sequence, last, timeout_ns >= 0 ? &deadline : nullptr);
+        if (temp == -1 && errno == ETIMEDOUT) break;
+        if (temp == -1 && errno != EAGAIN && errno != EINTR)
+        {
+            int error = errno;
+            waiters.fetch_sub(1);
+            sysexcept(true, "futex", error);
+        }
+    }
+    waiters.fetch_sub(1);
+
+    return sequence.load(std::memory_order_acquire);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
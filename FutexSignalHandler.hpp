@@ -0,0 +1,129 @@
+/*
+ * \file FutexSignalHandler.hpp
+ * \brief Header file de::Koesling::Signal::FutexSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalHandler.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Signal handler that hands signals off to a thread waiting on a futex
+ *
+ * The installed trampoline only increments a sequence number and wakes
+ * waiting threads with FUTEX_WAKE (one raw system call, no file descriptor).
+ * The wake up is skipped if no thread waits.
+ *
+ * usage:
+ *   FutexSignalHandler handler(SIGUSR1);
+ *   handler.establish();
+ *   std::uint32_t seq = handler.get_sequence();
+ *   for (;;) { seq = handler.wait(seq); ... }
+ *
+ * Note: standard signals (< SIGRTMIN) are merged by the kernel while they
+ * are pending. The difference of two sequence numbers is therefore a lower
+ * bound of the number of sent signals.
+ */
+class FutexSignalHandler : private SignalSink
+{
+    private:
+        //! signal number
+        int signal_number;
+
+        //! number of delivered signals (futex word)
+        std::atomic<std::uint32_t> sequence;
+
+        //! number of threads that are (about to be) blocked in wait()
+        std::atomic<std::uint32_t> waiters;
+
+        //! installed trampoline
+        SignalHandler signal_handler;
+
+        //! bump sequence and wake waiters (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+    public:
+        /*! \brief init FutexSignalHandler
+         *
+         * attributes:
+         *   signal_number  : signal which will be handled by this handler
+         *   sa_flags       : see man sigaction (sa_flags)
+         *   blocked_signals: see man sigaction (sa_mask)
+         * possible_throws:
+         *   std::invalid_argument: invalid signal number
+         *   std::logic_error     : another sink is attached to the signal
+         */
+        explicit FutexSignalHandler(int signal_number, int sa_flags = SA_RESTART, sigset_t *blocked_signals = nullptr);
+
+        //! revoke handler
+        ~FutexSignalHandler( );
+
+        /*! \brief arm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        inline void establish( );
+
+        /*! \brief disarm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         *   std::logic_error : major programming error
+         */
+        inline void revoke( );
+
+        //! get current sequence number
+        inline std::uint32_t get_sequence( ) const noexcept;
+
+        /*! \brief wait until the sequence number differs from last
+         *
+         * attributes:
+         *   last      : last seen sequence number
+         *   timeout_ns: timeout (negative: no timeout)
+         * returns the current sequence number (equals last on timeout)
+         *
+         * possible_throws:
+         *   std::system_error: futex system call failed
+         */
+        std::uint32_t wait(std::uint32_t last, std::int64_t timeout_ns = -1);
+
+        //! copying not allowed
+        FutexSignalHandler(const FutexSignalHandler &other) = delete;
+        //! copying not allowed
+        FutexSignalHandler& operator=(const FutexSignalHandler &other) = delete;
+};
+
+inline void FutexSignalHandler::establish( )
+{
+    signal_handler.establish( );
+}
+
+inline void FutexSignalHandler::revoke( )
+{
+    signal_handler.revoke( );
+}
+
+inline std::uint32_t FutexSignalHandler::get_sequence( ) const noexcept
+{
+    return sequence.load(std::memory_order_acquire);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
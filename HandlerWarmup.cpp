@@ -0,0 +1,110 @@
+/*
+ * \file HandlerWarmup.cpp
+ * \brief Source file de::Koesling::Signal::HandlerWarmup
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "HandlerWarmup.hpp"
+#include "common_header/sysexcept.hpp"
+#include <alloca.h>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <link.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! get page size
+static std::size_t page_size( ) noexcept
+{
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+//! executable segment lookup (dl_iterate_phdr)
+struct SegmentLookup
+{
+    //! searched address
+    std::uintptr_t address;
+    //! found segment
+    std::uintptr_t start;
+    std::uintptr_t end;
+};
+
+//! dl_iterate_phdr callback: find the executable PT_LOAD segment that contains the address
+static int find_segment(struct dl_phdr_info *info, std::size_t, void *data)
+{
+    SegmentLookup *lookup = static_cast<SegmentLookup*>(data);
+
+    for (ElfW(Half) i = 0; i < info->dlpi_phnum; ++i)
+    {
+        const ElfW(Phdr) &header = info->dlpi_phdr[i];
+        if (header.p_type != PT_LOAD || !(header.p_flags & PF_X)) continue;
+
+        const std::uintptr_t start = info->dlpi_addr + header.p_vaddr;
+        const std::uintptr_t end = start + header.p_memsz;
+        if (lookup->address >= start && lookup->address < end)
+        {
+            lookup->start = start;
+            lookup->end = end;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+__attribute__((noinline)) void HandlerWarmup::prefault_stack(std::size_t bytes) noexcept
+{
+    if (bytes == 0) return;
+
+    // the memory is released when this function returns
+    volatile char *stack = static_cast<volatile char*>(alloca(bytes));
+
+    // top down: the stack grows page by page
+    const std::size_t page = page_size( );
+    for (std::size_t offset = bytes; offset > page; offset -= page)
+        stack[offset - 1] = 0;
+    stack[0] = 0;
+}
+
+void HandlerWarmup::prefault_altstack( ) noexcept
+{
+    stack_t stack;
+    if (sigaltstack(nullptr, &stack) != 0) return;
+
+    // not installed or currently in use
+    if (stack.ss_flags & (SS_DISABLE | SS_ONSTACK)) return;
+
+    volatile char *memory = static_cast<volatile char*>(stack.ss_sp);
+    const std::size_t page = page_size( );
+    for (std::size_t offset = 0; offset < stack.ss_size; offset += page)
+        memory[offset] = 0;
+}
+
+void HandlerWarmup::lock_code(const void *address)
+{
+    SegmentLookup lookup { reinterpret_cast<std::uintptr_t>(address), 0, 0 };
+    if (dl_iterate_phdr(find_segment, &lookup) == 0)
+        throw std::invalid_argument("HandlerWarmup: address is not part of an executable segment.");
+
+    const std::uintptr_t page = page_size( );
+    const std::uintptr_t start = lookup.start & ~(page - 1);
+    int temp = mlock(reinterpret_cast<const void*>(start), lookup.end - start);
+    sysexcept(temp != 0, "mlock", errno);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,52 @@
+/*
+ * \file HandlerWarmup.hpp
+ * \brief Header file de::Koesling::Signal::HandlerWarmup
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Warm up the memory used by the first delivery of a signal
+ *
+ * The first delivery of a signal is usually much slower than later ones:
+ * the stack (or alternate stack) pages and the code pages of the handler
+ * are not yet mapped, and lazily bound symbols are resolved by the dynamic
+ * loader on the first call. Used by SignalHandler::enable_warmup().
+ */
+class HandlerWarmup
+{
+    public:
+        HandlerWarmup( ) = delete;
+
+        //! touch bytes of the calling thread's stack below the current frame
+        static void prefault_stack(std::size_t bytes) noexcept;
+
+        //! touch all pages of the alternate signal stack of the calling thread (if any)
+        static void prefault_altstack( ) noexcept;
+
+        /*! \brief lock the executable segment that contains address into memory
+         *
+         * possible_throws:
+         *   std::invalid_argument: address is not part of an executable segment
+         *   std::system_error    : mlock failed
+         */
+        static void lock_code(const void *address);
+};
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
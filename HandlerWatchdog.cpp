@@ -0,0 +1,140 @@
+/*
+ * \file HandlerWatchdog.cpp
+ * \brief Source file de::Koesling::Signal::HandlerWatchdog
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "HandlerWatchdog.hpp"
+#include "SignalEvent.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+constexpr std::size_t HandlerWatchdog::LOG_SIZE;
+constexpr std::size_t HandlerHistogram::BUCKETS;
+
+InnerHandler HandlerWatchdog::handlers[_NSIG];
+std::atomic<std::uint64_t> HandlerWatchdog::thresholds[_NSIG];
+std::atomic<std::uint64_t> HandlerWatchdog::buckets[_NSIG][HandlerHistogram::BUCKETS];
+std::atomic<std::uint64_t> HandlerWatchdog::counts[_NSIG];
+std::atomic<std::uint64_t> HandlerWatchdog::totals[_NSIG];
+std::atomic<std::uint64_t> HandlerWatchdog::maxima[_NSIG];
+HandlerWatchdog::LogSlot HandlerWatchdog::log[LOG_SIZE];
+std::atomic<std::uint64_t> HandlerWatchdog::log_index;
+
+void HandlerWatchdog::exchange(int signal_number, const struct sigaction &inner, std::uint64_t threshold,
+        struct sigaction &old_inner, std::uint64_t &old_threshold) noexcept
+{
+    handlers[signal_number].exchange(inner, old_inner);
+    old_threshold = thresholds[signal_number].exchange(threshold);
+}
+
+void HandlerWatchdog::handler(int signal_number, siginfo_t *info, void *context)
+{
+    const std::uint64_t start = monotonic_ns( );
+    void *function = handlers[signal_number].call(signal_number, info, context);
+    const std::uint64_t duration = monotonic_ns( ) - start;
+
+    // the handler may have modified errno, statistics must not
+    const int saved_errno = errno;
+
+    std::size_t bucket = duration == 0 ? 0 : 64 - static_cast<std::size_t>(__builtin_clzll(duration));
+    if (bucket >= HandlerHistogram::BUCKETS) bucket = HandlerHistogram::BUCKETS - 1;
+    buckets[signal_number][bucket].fetch_add(1, std::memory_order_relaxed);
+    counts[signal_number].fetch_add(1, std::memory_order_relaxed);
+    totals[signal_number].fetch_add(duration, std::memory_order_relaxed);
+
+    std::uint64_t max = maxima[signal_number].load(std::memory_order_relaxed);
+    while (duration > max && !maxima[signal_number].compare_exchange_weak(max, duration, std::memory_order_relaxed))
+        ;
+
+    if (duration > thresholds[signal_number].load(std::memory_order_relaxed))
+        log_slow(signal_number, function, duration, start);
+
+    errno = saved_errno;
+}
+
+void HandlerWatchdog::log_slow(int signal_number, void *handler, std::uint64_t duration,
+        std::uint64_t timestamp) noexcept
+{
+    const std::uint64_t index = log_index.fetch_add(1);
+    LogSlot &slot = log[index % LOG_SIZE];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.record.signal_number = signal_number;
+    slot.record.thread = static_cast<pid_t>(syscall(SYS_gettid));
+    slot.record.handler = handler;
+    slot.record.duration = duration;
+    slot.record.timestamp = timestamp;
+
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+HandlerHistogram HandlerWatchdog::get_histogram(int signal_number) noexcept
+{
+    HandlerHistogram histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    if (signal_number < SIGHUP || signal_number >= _NSIG) return histogram;
+
+    for (std::size_t i = 0; i < HandlerHistogram::BUCKETS; ++i)
+        histogram.buckets[i] = buckets[signal_number][i].load(std::memory_order_relaxed);
+    histogram.count = counts[signal_number].load(std::memory_order_relaxed);
+    histogram.total = totals[signal_number].load(std::memory_order_relaxed);
+    histogram.max = maxima[signal_number].load(std::memory_order_relaxed);
+    return histogram;
+}
+
+void HandlerWatchdog::reset_histogram(int signal_number) noexcept
+{
+    if (signal_number < SIGHUP || signal_number >= _NSIG) return;
+
+    for (auto &bucket : buckets[signal_number])
+        bucket.store(0, std::memory_order_relaxed);
+    counts[signal_number].store(0, std::memory_order_relaxed);
+    totals[signal_number].store(0, std::memory_order_relaxed);
+    maxima[signal_number].store(0, std::memory_order_relaxed);
+}
+
+std::vector<SlowHandlerRecord> HandlerWatchdog::read_slow_log(std::uint64_t &cursor)
+{
+    std::vector<SlowHandlerRecord> result;
+
+    const std::uint64_t end = log_index.load( );
+    if (end > LOG_SIZE && cursor < end - LOG_SIZE) cursor = end - LOG_SIZE;	// overwritten
+
+    for (; cursor < end; ++cursor)
+    {
+        const LogSlot &slot = log[cursor % LOG_SIZE];
+
+        const std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence < 2 * cursor + 2) break;	// write in progress --> read again next time
+        if (sequence > 2 * cursor + 2) continue;	// overwritten
+
+        SlowHandlerRecord record = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != 2 * cursor + 2) continue;	// overwritten while reading
+
+        result.push_back(record);
+    }
+
+    return result;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,141 @@
+/*
+ * \file HandlerWatchdog.hpp
+ * \brief Header file de::Koesling::Signal::HandlerWatchdog
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "InnerHandler.hpp"
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! handler invocation that exceeded the threshold
+struct SlowHandlerRecord
+{
+    //! signal number
+    int signal_number;
+    //! receiving thread (kernel thread id)
+    pid_t thread;
+    //! handler function
+    void *handler;
+    //! execution time in nanoseconds
+    std::uint64_t duration;
+    //! start time (CLOCK_MONOTONIC in nanoseconds)
+    std::uint64_t timestamp;
+};
+
+//! execution time histogram of a handler
+struct HandlerHistogram
+{
+    //! number of histogram buckets
+    static constexpr std::size_t BUCKETS = 40;
+
+    /*! \brief number of invocations per bucket
+     *
+     * bucket i: execution time < 2^i nanoseconds (and >= 2^(i-1))
+     * The last bucket contains all longer invocations.
+     */
+    std::uint64_t buckets[BUCKETS];
+    //! number of invocations
+    std::uint64_t count;
+    //! sum of all execution times in nanoseconds
+    std::uint64_t total;
+    //! longest execution time in nanoseconds
+    std::uint64_t max;
+};
+
+/*! \brief Execution time measurement of signal handlers
+ *
+ * Enabled per SignalHandler by SignalHandler::enable_timing().
+ * The handler is then invoked by a timing trampoline that measures the
+ * execution time with clock_gettime(CLOCK_MONOTONIC) (vDSO), updates the
+ * histogram of the signal and logs invocations that exceed the threshold
+ * into a lock free ring buffer (the oldest records are overwritten).
+ */
+class HandlerWatchdog
+{
+    public:
+        //! number of records in the slow handler log
+        static constexpr std::size_t LOG_SIZE = 1024;
+
+    private:
+        //! slow handler log entry (sequence lock)
+        struct LogSlot
+        {
+            //! 2 * index + 1: write in progress, 2 * index + 2: valid
+            std::atomic<std::uint64_t> sequence;
+            SlowHandlerRecord record;
+        };
+
+        //! timed handler function per signal
+        static InnerHandler handlers[_NSIG];
+
+        //! threshold per signal in nanoseconds
+        static std::atomic<std::uint64_t> thresholds[_NSIG];
+
+        //! histogram per signal
+        static std::atomic<std::uint64_t> buckets[_NSIG][HandlerHistogram::BUCKETS];
+        static std::atomic<std::uint64_t> counts[_NSIG];
+        static std::atomic<std::uint64_t> totals[_NSIG];
+        static std::atomic<std::uint64_t> maxima[_NSIG];
+
+        //! slow handler log
+        static LogSlot log[LOG_SIZE];
+
+        //! next log index
+        static std::atomic<std::uint64_t> log_index;
+
+        //! store slow invocation (signal handler context)
+        static void log_slow(int signal_number, void *handler, std::uint64_t duration,
+                std::uint64_t timestamp) noexcept;
+
+    public:
+        HandlerWatchdog( ) = delete;
+
+        /*! \brief set the timed handler of a signal (used by SignalHandler)
+         *
+         * inner.sa_handler / inner.sa_sigaction (selected by SA_SIGINFO) is
+         * called by the timing trampoline. The previous handler and threshold
+         * are stored in old_inner and old_threshold.
+         */
+        static void exchange(int signal_number, const struct sigaction &inner, std::uint64_t threshold,
+                struct sigaction &old_inner, std::uint64_t &old_threshold) noexcept;
+
+        //! timing trampoline (SignalHandler_extended_t)
+        static void handler(int signal_number, siginfo_t *info, void *context);
+
+        //! get execution time histogram of a signal
+        static HandlerHistogram get_histogram(int signal_number) noexcept;
+
+        //! reset execution time histogram of a signal
+        static void reset_histogram(int signal_number) noexcept;
+
+        /*! \brief read slow handler log
+         *
+         * Returns all records logged since cursor (start with cursor = 0) and
+         * updates cursor. Records that were overwritten before they were read
+         * are skipped.
+         */
+        static std::vector<SlowHandlerRecord> read_slow_log(std::uint64_t &cursor);
+};
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,154 @@
+/*
+ * \file HazardPointers.cpp
+ * \brief Source file de::Koesling::Signal::HazardPointers
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "HazardPointers.hpp"
+#include <algorithm>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+constexpr std::size_t HazardPointers::SLOTS;
+
+HazardPointers::HazardPointers(AsymmetricFence &fence, std::size_t reclaim_threshold) noexcept :
+        fence(fence),
+        reclaim_threshold(reclaim_threshold),
+        records(nullptr)
+{
+}
+
+HazardPointers::~HazardPointers( )
+{
+    for (const Retired &object : retired)
+        object.second(object.first);
+
+    Record *record = records.load( );
+    while (record != nullptr)
+    {
+        Record *next = record->next;
+        delete record;
+        record = next;
+    }
+}
+
+HazardPointers::Reader HazardPointers::register_thread( )
+{
+    std::lock_guard<std::mutex> lock(records_mutex);
+
+    Record *record = records.load( );
+    while (record != nullptr && record->active)
+        record = record->next;
+
+    if (record == nullptr)
+    {
+        record = new Record;
+        record->next = records.load( );
+        records.store(record);
+    }
+
+    for (auto &hazard : record->hazards)
+        hazard.store(nullptr, std::memory_order_relaxed);
+    record->thread = pthread_self( );
+    record->active = true;
+
+    return Reader(this, record);
+}
+
+void HazardPointers::unregister(Record *record) noexcept
+{
+    std::lock_guard<std::mutex> lock(records_mutex);
+    for (auto &hazard : record->hazards)
+        hazard.store(nullptr, std::memory_order_release);
+    record->active = false;
+}
+
+void HazardPointers::retire(void *object, Deleter_t deleter)
+{
+    bool reclaim_now;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        retired.emplace_back(object, deleter);
+        reclaim_now = retired.size( ) >= reclaim_threshold;
+    }
+
+    if (reclaim_now) reclaim( );
+}
+
+std::size_t HazardPointers::reclaim( )
+{
+    std::vector<Retired> candidates;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        candidates.swap(retired);
+    }
+    if (candidates.empty( )) return 0;
+
+    std::vector<void*> protected_pointers;
+    {
+        // registered threads can not exit (unregister) while they are fenced
+        std::lock_guard<std::mutex> lock(records_mutex);
+
+        std::vector<pthread_t> threads;
+        for (Record *record = records.load( ); record != nullptr; record = record->next)
+            if (record->active) threads.push_back(record->thread);
+
+        try
+        {
+            // make the plain hazard pointer stores of all readers visible
+            fence.heavy(threads);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> retired_lock(retired_mutex);
+            retired.insert(retired.end( ), candidates.begin( ), candidates.end( ));
+            throw;
+        }
+
+        for (Record *record = records.load( ); record != nullptr; record = record->next)
+            for (const auto &hazard : record->hazards)
+            {
+                void *pointer = hazard.load(std::memory_order_acquire);
+                if (pointer != nullptr) protected_pointers.push_back(pointer);
+            }
+    }
+    std::sort(protected_pointers.begin( ), protected_pointers.end( ));
+
+    std::size_t freed = 0;
+    std::vector<Retired> keep;
+    for (const Retired &object : candidates)
+    {
+        if (std::binary_search(protected_pointers.begin( ), protected_pointers.end( ), object.first))
+        {
+            keep.push_back(object);
+        }
+        else
+        {
+            object.second(object.first);
+            ++freed;
+        }
+    }
+
+    if (!keep.empty( ))
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        retired.insert(retired.end( ), keep.begin( ), keep.end( ));
+    }
+
+    return freed;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
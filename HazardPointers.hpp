@@ -0,0 +1,217 @@
+/*
+ * \file HazardPointers.hpp
+ * \brief Header file de::Koesling::Signal::HazardPointers
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "AsymmetricFence.hpp"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <pthread.h>
+#include <utility>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Hazard pointer based memory reclamation with asymmetric fences
+ *
+ * Readers publish the pointer they are going to access with a plain store
+ * and a compiler barrier (no fence instruction on the read path). Before
+ * the reclaimer scans the hazard pointers, it executes the heavy side of an
+ * AsymmetricFence on all registered threads (membarrier or signals). This
+ * makes all published hazard pointers visible and orders the readers'
+ * validation loads after the unlinking stores of the reclaimer.
+ *
+ * Reclamation is batched: retired objects are freed when more than
+ * reclaim_threshold objects are retired.
+ *
+ * usage:
+ *   auto reader = domain.register_thread();
+ *   Node *node = reader.protect(head);
+ *   ...
+ *   reader.clear();
+ *   domain.retire(old_node);   // after the node was unlinked
+ */
+class HazardPointers
+{
+    public:
+        //! number of hazard pointers per thread
+        static constexpr std::size_t SLOTS = 4;
+
+        //! deleter function type of retired objects
+        typedef void (*Deleter_t)(void*);
+
+    private:
+        //! hazard pointers of a thread
+        struct Record
+        {
+            //! published pointers
+            std::atomic<void*> hazards[SLOTS];
+            //! registered thread
+            pthread_t thread;
+            //! record is used by a thread
+            bool active;
+            //! next record
+            Record *next;
+        };
+
+        //! retired object
+        typedef std::pair<void*, Deleter_t> Retired;
+
+        //! fence used before scanning
+        AsymmetricFence &fence;
+
+        //! reclaim if more objects are retired
+        std::size_t reclaim_threshold;
+
+        //! thread records (only appended, reused after unregistration)
+        std::atomic<Record*> records;
+
+        //! protects record registration (and scanning)
+        std::mutex records_mutex;
+
+        //! retired objects
+        std::vector<Retired> retired;
+        std::mutex retired_mutex;
+
+        //! return record
+        void unregister(Record *record) noexcept;
+
+    public:
+        //! registration of a reader thread (RAII)
+        class Reader
+        {
+            private:
+                HazardPointers *domain;
+                Record *record;
+
+            public:
+                inline Reader(HazardPointers *domain, Record *record) noexcept;
+                inline ~Reader( );
+                inline Reader(Reader &&other) noexcept;
+
+                /*! \brief protect the object src points to
+                 *
+                 * returns the protected pointer (stays valid until clear(slot)
+                 * or the next protect(..., slot))
+                 */
+                template<typename T>
+                inline T* protect(const std::atomic<T*> &src, std::size_t slot = 0) noexcept;
+
+                //! release hazard pointer
+                inline void clear(std::size_t slot = 0) noexcept;
+
+                Reader(const Reader &other) = delete;
+                Reader& operator=(const Reader &other) = delete;
+                Reader& operator=(Reader &&other) = delete;
+        };
+
+        /*! \brief create domain
+         *
+         * attributes:
+         *   fence            : fence used before scanning (must outlive the domain)
+         *   reclaim_threshold: number of retired objects that triggers reclamation
+         */
+        explicit HazardPointers(AsymmetricFence &fence, std::size_t reclaim_threshold = 64) noexcept;
+
+        //! free all retired objects (no reader may exist anymore)
+        ~HazardPointers( );
+
+        /*! \brief register calling thread as reader
+         *
+         * possible_throws:
+         *   std::bad_alloc: out of memory
+         */
+        Reader register_thread( );
+
+        /*! \brief retire an unlinked object
+         *
+         * The object is freed by deleter as soon as no hazard pointer points to it.
+         *
+         * possible_throws:
+         *   std::bad_alloc   : out of memory
+         *   std::system_error: fence failed
+         */
+        void retire(void *object, Deleter_t deleter);
+
+        //! retire an object created by new
+        template<typename T>
+        inline void retire(T *object);
+
+        /*! \brief free all retired objects that are not protected
+         *
+         * returns the number of freed objects
+         *
+         * possible_throws:
+         *   std::system_error: fence failed
+         */
+        std::size_t reclaim( );
+
+        //! copying not allowed
+        HazardPointers(const HazardPointers &other) = delete;
+        //! copying not allowed
+        HazardPointers& operator=(const HazardPointers &other) = delete;
+};
+
+inline HazardPointers::Reader::Reader(HazardPointers *domain, Record *record) noexcept :
+        domain(domain),
+        record(record)
+{
+}
+
+inline HazardPointers::Reader::~Reader( )
+{
+    if (record != nullptr) domain->unregister(record);
+}
+
+inline HazardPointers::Reader::Reader(Reader &&other) noexcept :
+        domain(other.domain),
+        record(other.record)
+{
+    other.record = nullptr;
+}
+
+template<typename T>
+inline T* HazardPointers::Reader::protect(const std::atomic<T*> &src, std::size_t slot) noexcept
+{
+    T *pointer = src.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        // plain store: the reclaimer's heavy fence makes it visible
+        record->hazards[slot].store(pointer, std::memory_order_relaxed);
+        AsymmetricFence::light( );
+
+        T *current = src.load(std::memory_order_acquire);
+        if (current == pointer) return pointer;
+        pointer = current;
+    }
+}
+
+inline void HazardPointers::Reader::clear(std::size_t slot) noexcept
+{
+    record->hazards[slot].store(nullptr, std::memory_order_release);
+}
+
+template<typename T>
+inline void HazardPointers::retire(T *object)
+{
+    retire(object, [](void *pointer) { delete static_cast<T*>(pointer); });
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,270 @@
+/*
+ * \file HugePageArena.cpp
+ * \brief Source file de::Koesling::Signal::HugePageArena
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "HugePageArena.hpp"
+#include "common_header/sysexcept.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+constexpr std::size_t HugePageArena::HUGE_PAGE_SIZE;
+constexpr std::size_t HugePageArena::MIN_BLOCK_SIZE;
+constexpr unsigned HugePageArena::SIZE_CLASSES;
+std::atomic<std::uint64_t> HugePageArena::heap_fallbacks(0);
+std::atomic<HugePageArena*> HugePageArena::library_arena(nullptr);
+std::mutex HugePageArena::library_mutex;
+
+HugePageArena::HugePageArena(std::size_t size, bool lock) :
+        base(nullptr),
+        size((size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE),
+        used(0),
+        backing(Backing::HUGETLB),
+        locked(false),
+        altstack_bytes(0)
+{
+    if (size == 0) throw std::invalid_argument("HugePageArena: size must not be 0.");
+
+    for (auto &block : free_blocks)
+        block = nullptr;
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+    void *memory = mmap(nullptr, this->size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (memory == MAP_FAILED)
+    {
+        // no huge pages reserved: map aligned to the huge page size and request transparent huge pages
+        const std::size_t map_size = this->size + HUGE_PAGE_SIZE;
+        memory = mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        sysexcept(memory == MAP_FAILED, "mmap", errno);
+#pragma GCC diagnostic pop
+
+        char *start = static_cast<char*>(memory);
+        char *aligned = reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(start) + HUGE_PAGE_SIZE - 1)
+                & ~(HUGE_PAGE_SIZE - 1));
+        if (aligned != start) munmap(start, static_cast<std::size_t>(aligned - start));
+        const std::size_t tail = map_size - static_cast<std::size_t>(aligned - start) - this->size;
+        if (tail != 0) munmap(aligned + this->size, tail);
+        memory = aligned;
+
+        backing = madvise(memory, this->size, MADV_HUGEPAGE) == 0 ? Backing::TRANSPARENT : Backing::NORMAL;
+    }
+
+    base = static_cast<char*>(memory);
+
+    if (lock) locked = mlock(base, this->size) == 0;
+
+    // prefault (mlock already populates locked pages)
+    if (!locked)
+    {
+        const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        for (std::size_t offset = 0; offset < this->size; offset += page_size)
+            static_cast<volatile char*>(base)[offset] = 0;
+    }
+}
+
+HugePageArena::~HugePageArena( )
+{
+    munmap(base, size);
+}
+
+void* HugePageArena::allocate(std::size_t bytes, std::size_t alignment)
+{
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+        throw std::invalid_argument("HugePageArena: alignment must be a power of 2.");
+
+    std::size_t offset = used.load(std::memory_order_relaxed);
+    std::size_t start;
+    do
+    {
+        start = (offset + alignment - 1) & ~(alignment - 1);
+        if (start > size || bytes > size - start) throw std::bad_alloc( );
+    } while (!used.compare_exchange_weak(offset, start + bytes, std::memory_order_relaxed));
+
+    return base + start;
+}
+
+stack_t HugePageArena::allocate_altstack(std::size_t stack_size)
+{
+    if (stack_size < static_cast<std::size_t>(MINSIGSTKSZ))
+        throw std::invalid_argument("HugePageArena: alternate signal stack is smaller than MINSIGSTKSZ.");
+
+    const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    stack_size = (stack_size + page_size - 1) / page_size * page_size;
+
+    // own mapping: a guard page in the arena would split (THP) or waste (hugetlb) a huge page
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+    void *memory = mmap(nullptr, page_size + stack_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    sysexcept(memory == MAP_FAILED, "mmap", errno);
+#pragma GCC diagnostic pop
+
+    // the stack grows down: guard page below the stack
+    char *guard = static_cast<char*>(memory);
+    if (mprotect(guard, page_size, PROT_NONE) != 0)
+    {
+        const int error = errno;
+        munmap(memory, page_size + stack_size);
+        sysexcept(true, "mprotect", error);
+    }
+
+    char *stack_base = guard + page_size;
+    if (!locked || mlock(stack_base, stack_size) != 0)
+        for (std::size_t offset = 0; offset < stack_size; offset += page_size)
+            static_cast<volatile char*>(stack_base)[offset] = 0;
+    altstack_bytes.fetch_add(page_size + stack_size, std::memory_order_relaxed);
+
+    stack_t stack;
+    stack.ss_sp = stack_base;
+    stack.ss_size = stack_size;
+    stack.ss_flags = 0;
+    return stack;
+}
+
+void HugePageArena::release_altstack(const stack_t &stack) noexcept
+{
+    const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    munmap(static_cast<char*>(stack.ss_sp) - page_size, page_size + stack.ss_size);
+}
+
+void HugePageArena::install_altstack(std::size_t stack_size)
+{
+    stack_t stack = allocate_altstack(stack_size);
+    int temp = sigaltstack(&stack, nullptr);
+    sysexcept(temp != 0, "sigaltstack", errno);
+}
+
+void HugePageArena::write_usage(std::ostream &stream) const
+{
+    static const char *const backing_names[] = { "hugetlb", "transparent huge pages", "normal pages" };
+
+    std::size_t released = 0;
+    {
+        std::lock_guard<std::mutex> guard(free_mutex);
+        for (unsigned size_class = 0; size_class < SIZE_CLASSES; ++size_class)
+            for (const BlockHeader *block = free_blocks[size_class]; block != nullptr; block = block->next)
+                released += MIN_BLOCK_SIZE << size_class;
+    }
+
+    stream << "HugePageArena: " << get_used( ) << " of " << size << " bytes used ("
+            << backing_names[static_cast<int>(backing)] << (locked ? ", locked" : ", not locked") << ")\n";
+    stream << "  " << released << " bytes in released handler blocks, " << get_heap_fallbacks( )
+            << " handler allocations fell back to the heap, " << altstack_bytes.load( )
+            << " bytes of alternate signal stacks\n";
+}
+
+void HugePageArena::init_library(std::size_t size, bool lock)
+{
+    std::lock_guard<std::mutex> guard(library_mutex);
+    if (library_arena.load( ) != nullptr) throw std::logic_error("HugePageArena: library arena already exists.");
+    library_arena.store(new HugePageArena(size, lock));
+}
+
+HugePageArena& HugePageArena::library( )
+{
+    HugePageArena *arena = library_arena.load(std::memory_order_acquire);
+    if (arena != nullptr) return *arena;
+
+    std::lock_guard<std::mutex> guard(library_mutex);
+    arena = library_arena.load( );
+    if (arena == nullptr)
+    {
+        arena = new HugePageArena( );
+        library_arena.store(arena);
+    }
+    return *arena;
+}
+
+void* HugePageArena::allocate_block(std::size_t bytes) noexcept
+{
+    unsigned size_class = 0;
+    while ((MIN_BLOCK_SIZE << size_class) - MIN_BLOCK_SIZE < bytes)
+        if (++size_class == SIZE_CLASSES) return nullptr;
+
+    BlockHeader *block = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(free_mutex);
+        block = free_blocks[size_class];
+        if (block != nullptr) free_blocks[size_class] = block->next;
+    }
+
+    if (block == nullptr)
+    {
+        try
+        {
+            block = new (allocate(MIN_BLOCK_SIZE << size_class, MIN_BLOCK_SIZE)) BlockHeader;
+        }
+        catch (const std::bad_alloc&)
+        {
+            return nullptr;
+        }
+        block->size_class = size_class;
+    }
+
+    return reinterpret_cast<char*>(block) + MIN_BLOCK_SIZE;
+}
+
+void HugePageArena::release_block(void *memory) noexcept
+{
+    BlockHeader *block = reinterpret_cast<BlockHeader*>(static_cast<char*>(memory) - MIN_BLOCK_SIZE);
+
+    std::lock_guard<std::mutex> guard(free_mutex);
+    block->next = free_blocks[block->size_class];
+    free_blocks[block->size_class] = block;
+}
+
+void* HugePageArena::allocate_handler_memory(std::size_t bytes, std::size_t alignment)
+{
+    HugePageArena *arena = get_library( );
+    if (arena != nullptr)
+    {
+        void *memory = alignment <= MIN_BLOCK_SIZE ? arena->allocate_block(bytes) : nullptr;
+        if (memory != nullptr) return memory;
+
+        // arena exhausted --> heap (neither locked nor prefaulted)
+        heap_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // posix_memalign: operator new does not support over-aligned types before C++17
+    if (alignment < sizeof(void*)) alignment = sizeof(void*);
+    void *memory = nullptr;
+    if (posix_memalign(&memory, alignment, bytes) != 0) throw std::bad_alloc( );
+    return memory;
+}
+
+void HugePageArena::release_handler_memory(void *memory) noexcept
+{
+    if (memory == nullptr) return;
+
+    // the library arena is never destroyed
+    HugePageArena *arena = get_library( );
+    if (arena != nullptr && arena->contains(memory))
+        arena->release_block(memory);
+    else
+        free(memory);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,301 @@
+/*
+ * \file HugePageArena.hpp
+ * \brief Header file de::Koesling::Signal::HugePageArena
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <signal.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Preallocated memory for data that is accessed by signal handlers
+ *
+ * Signal handlers often touch cold memory (queues, alternate stacks) and
+ * take page faults and TLB misses. The arena is backed by 2 MB huge pages
+ * (falls back to transparent huge pages and finally to normal pages), locked
+ * into memory and prefaulted at construction. Memory is handed out by a
+ * lock free bump allocator and is released with the arena only.
+ *
+ * Once the library arena exists (see init_library()), the handler side
+ * buffers of the library (event queues, recorders, watchdog and sampler
+ * entries, counters) are carved from it (see allocate_handler_memory()).
+ */
+class HugePageArena
+{
+    public:
+        //! size of a huge page
+        static constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+        //! kind of pages backing the arena
+        enum class Backing
+        {
+            HUGETLB,     //!< explicit huge pages (MAP_HUGETLB)
+            TRANSPARENT, //!< transparent huge pages (madvise)
+            NORMAL       //!< normal pages
+        };
+
+    private:
+        //! mapped memory
+        char *base;
+
+        //! size of the mapped memory
+        std::size_t size;
+
+        //! number of allocated bytes
+        std::atomic<std::size_t> used;
+
+        //! kind of pages
+        Backing backing;
+
+        //! memory is locked (mlock)
+        bool locked;
+
+        //! header of a handler memory block (see allocate_handler_memory())
+        struct BlockHeader
+        {
+            //! block size is MIN_BLOCK_SIZE << size_class
+            unsigned size_class;
+            //! next released block of the same size class
+            BlockHeader *next;
+        };
+
+        //! size of the smallest handler memory block and of the block header (keeps the data 64 byte aligned)
+        static constexpr std::size_t MIN_BLOCK_SIZE = 64;
+
+        //! number of handler memory size classes
+        static constexpr unsigned SIZE_CLASSES = 32;
+
+        //! released handler memory blocks per size class
+        BlockHeader *free_blocks[SIZE_CLASSES];
+        mutable std::mutex free_mutex;
+
+        //! bytes of the alternate signal stacks (incl. guard pages)
+        std::atomic<std::size_t> altstack_bytes;
+
+        //! handler memory allocations served by the heap although the library arena exists
+        static std::atomic<std::uint64_t> heap_fallbacks;
+
+        //! get handler memory block (nullptr: arena exhausted)
+        void* allocate_block(std::size_t bytes) noexcept;
+
+        //! release handler memory block for reuse
+        void release_block(void *memory) noexcept;
+
+        //! library arena
+        static std::atomic<HugePageArena*> library_arena;
+        static std::mutex library_mutex;
+
+    public:
+        /*! \brief map, lock and prefault arena
+         *
+         * attributes:
+         *   size: size of the arena (rounded up to HUGE_PAGE_SIZE)
+         *   lock: lock arena into memory (failure is not fatal, see is_locked())
+         * possible_throws:
+         *   std::invalid_argument: size is 0
+         *   std::system_error    : mmap failed
+         */
+        explicit HugePageArena(std::size_t size = HUGE_PAGE_SIZE, bool lock = true);
+
+        //! unmap arena
+        ~HugePageArena( );
+
+        /*! \brief allocate memory
+         *
+         * thread safe, async-signal-safe (if no exception is thrown)
+         *
+         * attributes:
+         *   bytes    : number of bytes
+         *   alignment: alignment (power of 2)
+         * possible_throws:
+         *   std::bad_alloc: arena exhausted
+         */
+        void* allocate(std::size_t bytes, std::size_t alignment = 64);
+
+        /*! \brief allocate an alternate signal stack
+         *
+         * The stack is a separate mapping (not arena memory) with a PROT_NONE
+         * guard page below it: a stack overflow faults instead of corrupting
+         * other memory, and no huge page of the arena is split or wasted as
+         * guard. The stack is locked if the arena is locked and prefaulted.
+         * The stack size is rounded up to the page size.
+         *
+         * possible_throws:
+         *   std::invalid_argument: size is less than MINSIGSTKSZ
+         *   std::system_error    : mmap or mprotect failed
+         */
+        stack_t allocate_altstack(std::size_t stack_size = SIGSTKSZ);
+
+        //! unmap a stack of allocate_altstack() (must not be installed anymore)
+        static void release_altstack(const stack_t &stack) noexcept;
+
+        /*! \brief allocate an alternate signal stack and install it for the calling thread
+         *
+         * (use SA_ONSTACK to execute handlers on the alternate stack)
+         *
+         * possible_throws:
+         *   std::invalid_argument: size is less than MINSIGSTKSZ
+         *   std::system_error    : mmap, mprotect or sigaltstack failed
+         */
+        void install_altstack(std::size_t stack_size = SIGSTKSZ);
+
+        //! check if memory belongs to the arena
+        inline bool contains(const void *memory) const noexcept;
+
+        //! get size of the arena
+        inline std::size_t get_size( ) const noexcept;
+
+        //! get number of allocated bytes
+        inline std::size_t get_used( ) const noexcept;
+
+        //! get kind of pages backing the arena
+        inline Backing get_backing( ) const noexcept;
+
+        //! check if the arena is locked into memory
+        inline bool is_locked( ) const noexcept;
+
+        //! write usage report
+        void write_usage(std::ostream &stream) const;
+
+        /*! \brief create the library arena
+         *
+         * possible_throws:
+         *   std::logic_error : library arena already exists
+         *   std::system_error: mmap failed
+         */
+        static void init_library(std::size_t size, bool lock = true);
+
+        /*! \brief get the library arena
+         *
+         * Creates the arena with the default size if init_library() was not called.
+         *
+         * possible_throws:
+         *   std::system_error: mmap failed
+         */
+        static HugePageArena& library( );
+
+        //! get the library arena (nullptr if it was not created yet)
+        inline static HugePageArena* get_library( ) noexcept;
+
+        /*! \brief allocate memory for data that is accessed by signal handlers
+         *
+         * The memory is taken from the library arena if it exists and from
+         * the heap otherwise. Arena blocks are rounded up to a power of 2;
+         * released blocks are reused by allocations of the same size class.
+         * If the library arena is exhausted (or alignment is greater than 64)
+         * the heap is used and the fallback is counted (see
+         * get_heap_fallbacks(), write_usage()).
+         *
+         * possible_throws:
+         *   std::bad_alloc: out of memory
+         */
+        static void* allocate_handler_memory(std::size_t bytes, std::size_t alignment = 64);
+
+        //! release memory of allocate_handler_memory() (arena blocks are kept for reuse)
+        static void release_handler_memory(void *memory) noexcept;
+
+        //! get number of handler memory allocations that fell back to the heap although the library arena exists
+        inline static std::uint64_t get_heap_fallbacks( ) noexcept;
+
+        /*! \brief create object in memory of allocate_handler_memory()
+         *
+         * (use Deleter to destroy the object)
+         *
+         * possible_throws:
+         *   std::bad_alloc: out of memory
+         *   exceptions of the constructor of T
+         */
+        template<typename T>
+        static T* create( );
+
+        //! deleter for objects created by create()
+        struct Deleter
+        {
+            template<typename T>
+            void operator()(T *object) const noexcept;
+        };
+
+        //! copying not allowed
+        HugePageArena(const HugePageArena &other) = delete;
+        //! copying not allowed
+        HugePageArena& operator=(const HugePageArena &other) = delete;
+};
+
+inline bool HugePageArena::contains(const void *memory) const noexcept
+{
+    return memory >= base && memory < base + size;
+}
+
+inline std::size_t HugePageArena::get_size( ) const noexcept
+{
+    return size;
+}
+
+inline std::size_t HugePageArena::get_used( ) const noexcept
+{
+    return used.load(std::memory_order_relaxed);
+}
+
+inline HugePageArena::Backing HugePageArena::get_backing( ) const noexcept
+{
+    return backing;
+}
+
+inline bool HugePageArena::is_locked( ) const noexcept
+{
+    return locked;
+}
+
+inline HugePageArena* HugePageArena::get_library( ) noexcept
+{
+    return library_arena.load(std::memory_order_acquire);
+}
+
+inline std::uint64_t HugePageArena::get_heap_fallbacks( ) noexcept
+{
+    return heap_fallbacks.load(std::memory_order_relaxed);
+}
+
+template<typename T>
+T* HugePageArena::create( )
+{
+    void *memory = allocate_handler_memory(sizeof(T), alignof(T) > 64 ? alignof(T) : 64);
+    try
+    {
+        return new (memory) T( );
+    }
+    catch (...)
+    {
+        release_handler_memory(memory);
+        throw;
+    }
+}
+
+template<typename T>
+void HugePageArena::Deleter::operator()(T *object) const noexcept
+{
+    object->~T( );
+    release_handler_memory(object);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
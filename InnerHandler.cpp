@@ -0,0 +1,53 @@
+/*
+ * \file InnerHandler.cpp
+ * \brief Source file de::Koesling::Signal::InnerHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "InnerHandler.hpp"
+#include <cstring>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+void InnerHandler::exchange(const struct sigaction &inner, struct sigaction &old_inner) noexcept
+{
+    memset(&old_inner, 0, sizeof(old_inner));
+
+    // install new handler before the old one is removed: call() prefers the
+    // extended handler, so there is no window without handler
+    void (*old_handler)(int);
+    void (*old_extended)(int, siginfo_t*, void*);
+    if (inner.sa_flags & SA_SIGINFO)
+    {
+        old_extended = extended_handler.exchange(inner.sa_sigaction);
+        old_handler = handler.exchange(nullptr);
+    }
+    else
+    {
+        old_handler = handler.exchange(inner.sa_handler);
+        old_extended = extended_handler.exchange(nullptr);
+    }
+
+    // sa_handler and sa_sigaction may share storage --> set only one of them
+    if (old_extended != nullptr)
+    {
+        old_inner.sa_sigaction = old_extended;
+        old_inner.sa_flags = SA_SIGINFO;
+    }
+    else
+        old_inner.sa_handler = old_handler;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,73 @@
+/*
+ * \file InnerHandler.hpp
+ * \brief Header file de::Koesling::Signal::InnerHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <csignal>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Handler function called by a trampoline of this library
+ *
+ * Stores the plain (sa_handler) or extended (sa_sigaction) handler
+ * function of a sigaction structure, selected by SA_SIGINFO.
+ * Used by the timing (HandlerWatchdog) and counting (DeliveryCounter)
+ * trampolines. Objects with static storage duration need no initialization.
+ */
+class InnerHandler
+{
+    private:
+        //! handler function without SA_SIGINFO
+        std::atomic<void (*)(int)> handler;
+
+        //! handler function with SA_SIGINFO
+        std::atomic<void (*)(int, siginfo_t*, void*)> extended_handler;
+
+    public:
+        /*! \brief set the handler function
+         *
+         * The previous handler function is stored in old_inner
+         * (sa_handler or sa_sigaction + SA_SIGINFO, all other members are 0).
+         * async-signal-safe
+         */
+        void exchange(const struct sigaction &inner, struct sigaction &old_inner) noexcept;
+
+        /*! \brief call the handler function
+         *
+         * Returns the called function (nullptr: no handler function).
+         * async-signal-safe
+         */
+        inline void* call(int signal_number, siginfo_t *info, void *context) const;
+};
+
+inline void* InnerHandler::call(int signal_number, siginfo_t *info, void *context) const
+{
+    void (*extended)(int, siginfo_t*, void*) = extended_handler.load( );
+    if (extended != nullptr)
+    {
+        extended(signal_number, info, context);
+        return reinterpret_cast<void*>(extended);
+    }
+
+    void (*plain)(int) = handler.load( );
+    if (plain != nullptr) plain(signal_number);
+    return reinterpret_cast<void*>(plain);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
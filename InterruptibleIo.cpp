@@ -0,0 +1,234 @@
+/*
+ * \file InterruptibleIo.cpp
+ * \brief Source file de::Koesling::Signal::InterruptibleIo
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "InterruptibleIo.hpp"
+#include "Cancellation.hpp"
+#include "Futex.hpp"
+#include "SignalEvent.hpp"
+#include "SignalRegistry.hpp"
+#include <cerrno>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! registered call sites
+static std::atomic<CallSite*> call_sites(nullptr);
+
+CallSite::CallSite(const char *name) noexcept :
+        name(name),
+        calls(0),
+        interrupted(0),
+        retry_time(0),
+        next(call_sites.load( ))
+{
+    while (!call_sites.compare_exchange_weak(next, this))
+        ;
+}
+
+//! interruption requested by interrupt() (initial-exec: accessed by signal handlers)
+static thread_local volatile sig_atomic_t interrupt_requested __attribute__((tls_model("initial-exec"))) = 0;
+
+// check (and consume) interruption request
+static inline bool abort_requested(InterruptibleIo::AbortPredicate_t abort) noexcept
+{
+    if (interrupt_requested)
+    {
+        interrupt_requested = 0;
+        return true;
+    }
+    return Cancellation::is_cancelled( ) || (abort != nullptr && abort( ));
+}
+
+// count interrupted attempt (returns the time of the EINTR result)
+static inline std::uint64_t count_interruption(CallSite &site) noexcept
+{
+    site.interrupted.fetch_add(1, std::memory_order_relaxed);
+    return monotonic_ns( );
+}
+
+// count time from the EINTR result until the retry is issued (0: first attempt)
+static inline void count_retry(CallSite &site, std::uint64_t interrupted_at) noexcept
+{
+    if (interrupted_at != 0) site.retry_time.fetch_add(monotonic_ns( ) - interrupted_at, std::memory_order_relaxed);
+}
+
+ssize_t InterruptibleIo::read(int fd, void *buffer, std::size_t count, CallSite &site, AbortPredicate_t abort) noexcept
+{
+    site.calls.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t interrupted_at = 0;
+    for (;;)
+    {
+        if (abort_requested(abort))
+        {
+            errno = EINTR;
+            return -1;
+        }
+
+        count_retry(site, interrupted_at);
+        ssize_t temp = ::read(fd, buffer, count);
+        if (temp != -1 || errno != EINTR) return temp;
+        interrupted_at = count_interruption(site);
+    }
+}
+
+ssize_t InterruptibleIo::write(int fd, const void *buffer, std::size_t count, CallSite &site,
+        AbortPredicate_t abort) noexcept
+{
+    site.calls.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t interrupted_at = 0;
+    for (;;)
+    {
+        if (abort_requested(abort))
+        {
+            errno = EINTR;
+            return -1;
+        }
+
+        count_retry(site, interrupted_at);
+        ssize_t temp = ::write(fd, buffer, count);
+        if (temp != -1 || errno != EINTR) return temp;
+        interrupted_at = count_interruption(site);
+    }
+}
+
+ssize_t InterruptibleIo::write_all(int fd, const void *buffer, std::size_t count, CallSite &site,
+        AbortPredicate_t abort) noexcept
+{
+    std::size_t done = 0;
+    while (done < count)
+    {
+        ssize_t temp = write(fd, static_cast<const char*>(buffer) + done, count - done, site, abort);
+        if (temp == -1) return done == 0 ? -1 : static_cast<ssize_t>(done);
+        done += static_cast<std::size_t>(temp);
+    }
+    return static_cast<ssize_t>(done);
+}
+
+int InterruptibleIo::accept(int fd, sockaddr *address, socklen_t *address_length, int flags, CallSite &site,
+        AbortPredicate_t abort) noexcept
+{
+    site.calls.fetch_add(1, std::memory_order_relaxed);
+
+    // the address length is an in/out argument
+    const socklen_t length = address_length != nullptr ? *address_length : 0;
+    std::uint64_t interrupted_at = 0;
+    for (;;)
+    {
+        if (abort_requested(abort))
+        {
+            errno = EINTR;
+            return -1;
+        }
+
+        count_retry(site, interrupted_at);
+        int temp = accept4(fd, address, address_length, flags);
+        if (temp != -1 || errno != EINTR) return temp;
+        interrupted_at = count_interruption(site);
+        if (address_length != nullptr) *address_length = length;
+    }
+}
+
+int InterruptibleIo::poll(pollfd *fds, nfds_t nfds, int timeout_ms, CallSite &site, AbortPredicate_t abort) noexcept
+{
+    site.calls.fetch_add(1, std::memory_order_relaxed);
+
+    const std::uint64_t deadline = monotonic_ns( ) + static_cast<std::uint64_t>(timeout_ms) * 1000000u;
+    int remaining = timeout_ms;
+    std::uint64_t interrupted_at = 0;
+    for (;;)
+    {
+        if (abort_requested(abort))
+        {
+            errno = EINTR;
+            return -1;
+        }
+
+        count_retry(site, interrupted_at);
+        int temp = ::poll(fds, nfds, remaining);
+        if (temp != -1 || errno != EINTR) return temp;
+        interrupted_at = count_interruption(site);
+
+        if (timeout_ms < 0) continue;	// infinite timeout
+
+        const std::uint64_t now = monotonic_ns( );
+        if (now >= deadline) return 0;	// timeout expired while interrupted
+        // round up: do not return before the deadline
+        remaining = static_cast<int>((deadline - now + 999999u) / 1000000u);
+    }
+}
+
+int InterruptibleIo::futex_wait(std::atomic<std::uint32_t> &word, std::uint32_t expected, std::int64_t timeout_ns,
+        CallSite &site, AbortPredicate_t abort) noexcept
+{
+    site.calls.fetch_add(1, std::memory_order_relaxed);
+
+    // absolute deadline: retries automatically wait for the remaining time only
+    struct timespec deadline;
+    if (timeout_ns >= 0)
+    {
+        const std::uint64_t end = monotonic_ns( ) + static_cast<std::uint64_t>(timeout_ns);
+        deadline.tv_sec = static_cast<time_t>(end / 1000000000u);
+        deadline.tv_nsec = static_cast<long>(end % 1000000000u);
+    }
+
+    std::uint64_t interrupted_at = 0;
+    for (;;)
+    {
+        if (abort_requested(abort))
+        {
+            errno = EINTR;
+            return -1;
+        }
+
+        count_retry(site, interrupted_at);
+        long temp = Signal::futex_wait(word, expected, timeout_ns >= 0 ? &deadline : nullptr);
+        if (temp == 0 || errno == EAGAIN) return 0;
+        if (errno != EINTR) return -1;
+        interrupted_at = count_interruption(site);
+    }
+}
+
+void InterruptibleIo::interrupt( ) noexcept
+{
+    interrupt_requested = 1;
+}
+
+void InterruptibleIo::clear_interrupt( ) noexcept
+{
+    interrupt_requested = 0;
+}
+
+sigset_t InterruptibleIo::get_interrupting_signals( ) noexcept
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    for (int i = SIGHUP; i < _NSIG; ++i)
+        if (SignalRegistry::is_handled(i) && !(SignalRegistry::get_flags(i) & SA_RESTART)) sigaddset(&signals, i);
+    return signals;
+}
+
+void InterruptibleIo::write_statistics(std::ostream &stream)
+{
+    for (const CallSite *site = call_sites.load( ); site != nullptr; site = site->next)
+    {
+        stream << site->name << ": " << site->calls.load( ) << " calls, " << site->interrupted.load( )
+                << " interrupted (" << site->retry_time.load( ) / 1000 << " us from EINTR to retry)\n";
+    }
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
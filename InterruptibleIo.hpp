@@ -0,0 +1,145 @@
+/*
+ * \file InterruptibleIo.hpp
+ * \brief Header file de::Koesling::Signal::InterruptibleIo
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief interruption statistics of one call site
+ *
+ * Call sites register themselves in a global list on construction and
+ * must have static storage duration.
+ *
+ * usage:
+ *   static CallSite site("server: accept");
+ *   int fd = InterruptibleIo::accept(listen_fd, nullptr, nullptr, 0, site);
+ */
+struct CallSite
+{
+    //! call site name
+    const char *name;
+    //! number of calls
+    std::atomic<std::uint64_t> calls;
+    //! number of EINTR results that were retried
+    std::atomic<std::uint64_t> interrupted;
+    //! retry overhead: time from an EINTR result until the retried call is issued (nanoseconds)
+    std::atomic<std::uint64_t> retry_time;
+    //! next registered call site
+    CallSite *next;
+
+    //! create and register call site
+    explicit CallSite(const char *name) noexcept;
+
+    //! copying not allowed
+    CallSite(const CallSite &other) = delete;
+    //! copying not allowed
+    CallSite& operator=(const CallSite &other) = delete;
+};
+
+/*! \brief EINTR aware system call wrappers
+ *
+ * Signal handlers installed without SA_RESTART make blocking system calls
+ * fail with EINTR (some calls like poll and futex waits are interrupted
+ * regardless of SA_RESTART). The wrappers retry interrupted calls, keep
+ * the original timeout (the remaining time is used for the retry) and count
+ * the interruptions per call site.
+ *
+ * Interruptions that are requested are not retried, the wrappers return -1
+ * with errno EINTR instead:
+ *   - interrupt() was called by the calling thread (e.g. by the handler of
+ *     ThreadKicker) since the last returned interruption
+ *   - the calling thread is cancelled (see Cancellation)
+ *   - the abort predicate returns true
+ * The request is checked before every attempt. A request that arrives
+ * after this check but before the thread blocks in the system call does
+ * not interrupt it (the call blocks until it completes or the next signal
+ * arrives): repeat the request until the thread reacts, e.g. with
+ * ThreadKicker::kick_until().
+ *
+ * All other errors are returned unchanged (-1 and errno).
+ */
+class InterruptibleIo
+{
+    public:
+        //! abort predicate: interrupted calls are not retried if it returns true
+        typedef bool (*AbortPredicate_t)( );
+
+        InterruptibleIo( ) = delete;
+
+        //! read (see man read)
+        static ssize_t read(int fd, void *buffer, std::size_t count, CallSite &site,
+                AbortPredicate_t abort = nullptr) noexcept;
+
+        //! write (see man write)
+        static ssize_t write(int fd, const void *buffer, std::size_t count, CallSite &site,
+                AbortPredicate_t abort = nullptr) noexcept;
+
+        //! write all data (retries partial writes)
+        static ssize_t write_all(int fd, const void *buffer, std::size_t count, CallSite &site,
+                AbortPredicate_t abort = nullptr) noexcept;
+
+        //! accept4 (see man accept4)
+        static int accept(int fd, sockaddr *address, socklen_t *address_length, int flags, CallSite &site,
+                AbortPredicate_t abort = nullptr) noexcept;
+
+        /*! \brief poll (see man poll)
+         *
+         * timeout_ms is the total timeout of all attempts
+         */
+        static int poll(pollfd *fds, nfds_t nfds, int timeout_ms, CallSite &site,
+                AbortPredicate_t abort = nullptr) noexcept;
+
+        /*! \brief futex wait (see Futex.hpp)
+         *
+         * Waits while word contains expected.
+         * timeout_ns: total timeout of all attempts (negative: no timeout)
+         * returns 0 (woken or value changed) or -1 (errno: ETIMEDOUT, EINTR, ...)
+         */
+        static int futex_wait(std::atomic<std::uint32_t> &word, std::uint32_t expected, std::int64_t timeout_ns,
+                CallSite &site, AbortPredicate_t abort = nullptr) noexcept;
+
+        /*! \brief request interruption of the current or next wrapped call of the calling thread
+         *
+         * async-signal-safe (intended for signal handlers)
+         */
+        static void interrupt( ) noexcept;
+
+        //! discard an interruption request of the calling thread
+        static void clear_interrupt( ) noexcept;
+
+        /*! \brief get signals that interrupt blocking system calls
+         *
+         * Signals handled by established SignalHandler objects without
+         * SA_RESTART.
+         */
+        static sigset_t get_interrupting_signals( ) noexcept;
+
+        //! write statistics of all call sites
+        static void write_statistics(std::ostream &stream);
+};
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,268 @@
+/*
+ * \file IoUring.cpp
+ * \brief Source file de::Koesling::Signal::IoUring
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * requires linux 5.6 or higher
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "IoUring.hpp"
+#include "common_header/sysexcept.hpp"
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+// no libc wrappers available
+static inline int sys_io_uring_setup(unsigned entries, io_uring_params *params)
+{
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static inline int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+// get pointer to field of a mapped ring
+template<typename T>
+static inline T* ring_field(void *ring, unsigned offset)
+{
+    return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+}
+
+IoUring::IoUring(unsigned entries, unsigned flags) :
+        ring_fd(-1),
+        sq_ring(MAP_FAILED),
+        sq_ring_size(0),
+        cq_ring(MAP_FAILED),
+        cq_ring_size(0),
+        sqes(nullptr),
+        sqes_size(0),
+        sqe_head(0),
+        sqe_tail(0)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = flags;
+
+    ring_fd = sys_io_uring_setup(entries, &params);
+    sysexcept(ring_fd == -1, "io_uring_setup", errno);
+    features = params.features;
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    // both rings share one mapping if supported by the kernel
+    if (features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (cq_ring_size > sq_ring_size) sq_ring_size = cq_ring_size;
+        cq_ring_size = sq_ring_size;
+    }
+
+    sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+            IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED)
+    {
+        int error = errno;
+        release( );
+        sysexcept(true, "mmap", error);
+    }
+
+    if (features & IORING_FEAT_SINGLE_MMAP)
+    {
+        cq_ring = sq_ring;
+    }
+    else
+    {
+        cq_ring = mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+                IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED)
+        {
+            int error = errno;
+            release( );
+            sysexcept(true, "mmap", error);
+        }
+    }
+
+    sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void *temp = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd,
+            IORING_OFF_SQES);
+    if (temp == MAP_FAILED)
+    {
+        int error = errno;
+        release( );
+        sysexcept(true, "mmap", error);
+    }
+    sqes = static_cast<io_uring_sqe*>(temp);
+
+    sq_head = ring_field<unsigned>(sq_ring, params.sq_off.head);
+    sq_tail = ring_field<unsigned>(sq_ring, params.sq_off.tail);
+    sq_mask = ring_field<unsigned>(sq_ring, params.sq_off.ring_mask);
+    sq_entries = ring_field<unsigned>(sq_ring, params.sq_off.ring_entries);
+    sq_array = ring_field<unsigned>(sq_ring, params.sq_off.array);
+
+    cq_head = ring_field<unsigned>(cq_ring, params.cq_off.head);
+    cq_tail = ring_field<unsigned>(cq_ring, params.cq_off.tail);
+    cq_mask = ring_field<unsigned>(cq_ring, params.cq_off.ring_mask);
+    cqes = ring_field<io_uring_cqe>(cq_ring, params.cq_off.cqes);
+
+    sqe_head = sqe_tail = *sq_tail;
+}
+
+IoUring::~IoUring( )
+{
+    release( );
+}
+
+void IoUring::release( ) noexcept
+{
+    if (sqes != nullptr) munmap(sqes, sqes_size);
+    if (cq_ring != MAP_FAILED && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+    if (sq_ring != MAP_FAILED) munmap(sq_ring, sq_ring_size);
+    if (ring_fd != -1) close(ring_fd);
+
+    sqes = nullptr;
+    cq_ring = MAP_FAILED;
+    sq_ring = MAP_FAILED;
+    ring_fd = -1;
+}
+
+io_uring_sqe* IoUring::get_sqe( ) noexcept
+{
+    const unsigned head = __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+    if (sqe_tail - head >= *sq_entries) return nullptr;	// submission queue full
+
+    io_uring_sqe *sqe = &sqes[sqe_tail & *sq_mask];
+    ++sqe_tail;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+unsigned IoUring::submit(unsigned wait_nr)
+{
+    // publish all sqes acquired by get_sqe()
+    unsigned tail = *sq_tail;
+    const unsigned to_submit = sqe_tail - sqe_head;
+    for (unsigned i = 0; i < to_submit; ++i)
+    {
+        sq_array[tail & *sq_mask] = sqe_head & *sq_mask;
+        ++tail;
+        ++sqe_head;
+    }
+    __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+    if (to_submit == 0 && wait_nr == 0) return 0;
+
+    const unsigned flags = wait_nr != 0 ? IORING_ENTER_GETEVENTS : 0;
+    int temp;
+    do
+    {
+        temp = sys_io_uring_enter(ring_fd, to_submit, wait_nr, flags);
+    } while (temp == -1 && errno == EINTR);
+    sysexcept(temp == -1, "io_uring_enter", errno);
+
+    return static_cast<unsigned>(temp);
+}
+
+io_uring_cqe* IoUring::peek_cqe( ) noexcept
+{
+    const unsigned head = *cq_head;
+    if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) return nullptr;	// no completion available
+    return &cqes[head & *cq_mask];
+}
+
+io_uring_cqe* IoUring::wait_cqe( )
+{
+    io_uring_cqe *cqe = peek_cqe( );
+    while (cqe == nullptr)
+    {
+        submit(1);
+        cqe = peek_cqe( );
+    }
+    return cqe;
+}
+
+void IoUring::cqe_seen( ) noexcept
+{
+    __atomic_store_n(cq_head, *cq_head + 1, __ATOMIC_RELEASE);
+}
+
+IoUring::IoUring(IoUring &&other) noexcept :
+        ring_fd(other.ring_fd),
+        sq_ring(other.sq_ring),
+        sq_ring_size(other.sq_ring_size),
+        cq_ring(other.cq_ring),
+        cq_ring_size(other.cq_ring_size),
+        sqes(other.sqes),
+        sqes_size(other.sqes_size),
+        sq_head(other.sq_head),
+        sq_tail(other.sq_tail),
+        sq_mask(other.sq_mask),
+        sq_entries(other.sq_entries),
+        sq_array(other.sq_array),
+        cq_head(other.cq_head),
+        cq_tail(other.cq_tail),
+        cq_mask(other.cq_mask),
+        cqes(other.cqes),
+        sqe_head(other.sqe_head),
+        sqe_tail(other.sqe_tail),
+        features(other.features)
+{
+    other.ring_fd = -1;
+    other.sq_ring = MAP_FAILED;
+    other.cq_ring = MAP_FAILED;
+    other.sqes = nullptr;
+}
+
+IoUring& IoUring::operator=(IoUring &&other) noexcept
+{
+    if (this != &other)	// skip self assignment
+    {
+        release( );
+
+        ring_fd = other.ring_fd;
+        sq_ring = other.sq_ring;
+        sq_ring_size = other.sq_ring_size;
+        cq_ring = other.cq_ring;
+        cq_ring_size = other.cq_ring_size;
+        sqes = other.sqes;
+        sqes_size = other.sqes_size;
+        sq_head = other.sq_head;
+        sq_tail = other.sq_tail;
+        sq_mask = other.sq_mask;
+        sq_entries = other.sq_entries;
+        sq_array = other.sq_array;
+        cq_head = other.cq_head;
+        cq_tail = other.cq_tail;
+        cq_mask = other.cq_mask;
+        cqes = other.cqes;
+        sqe_head = other.sqe_head;
+        sqe_tail = other.sqe_tail;
+        features = other.features;
+
+        other.ring_fd = -1;
+        other.sq_ring = MAP_FAILED;
+        other.cq_ring = MAP_FAILED;
+        other.sqes = nullptr;
+    }
+    return *this;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
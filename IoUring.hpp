@@ -0,0 +1,158 @@
+/*
+ * \file IoUring.hpp
+ * \brief Header file de::Koesling::Signal::IoUring
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * requires linux 5.6 or higher
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <linux/io_uring.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Minimal io_uring instance
+ *
+ * Thin wrapper around the raw io_uring system calls (no liburing required).
+ * The ring is not thread safe: submission and completion must be done by
+ * the same thread (or externally synchronized).
+ */
+class IoUring
+{
+    private:
+        //! io_uring file descriptor (-1 if moved)
+        int ring_fd;
+
+        //! mapped submission queue ring
+        void *sq_ring;
+        //! size of the mapped submission queue ring
+        std::size_t sq_ring_size;
+
+        //! mapped completion queue ring (same as sq_ring if IORING_FEAT_SINGLE_MMAP)
+        void *cq_ring;
+        //! size of the mapped completion queue ring
+        std::size_t cq_ring_size;
+
+        //! mapped submission queue entries
+        io_uring_sqe *sqes;
+        //! size of the mapped submission queue entries
+        std::size_t sqes_size;
+
+        //! submission queue ring fields (shared with the kernel)
+        unsigned *sq_head;
+        unsigned *sq_tail;
+        unsigned *sq_mask;
+        unsigned *sq_entries;
+        unsigned *sq_array;
+
+        //! completion queue ring fields (shared with the kernel)
+        unsigned *cq_head;
+        unsigned *cq_tail;
+        unsigned *cq_mask;
+        io_uring_cqe *cqes;
+
+        //! first sqe that was handed out by get_sqe(), but not submitted yet
+        unsigned sqe_head;
+        //! next sqe that is handed out by get_sqe()
+        unsigned sqe_tail;
+
+        //! features reported by the kernel (see io_uring_params.features)
+        unsigned features;
+
+        //! unmap all rings and close the file descriptor
+        void release( ) noexcept;
+
+    public:
+        /*! \brief create io_uring
+         *
+         * attributes:
+         *   entries: number of submission queue entries
+         *   flags  : see man io_uring_setup (io_uring_params.flags)
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        explicit IoUring(unsigned entries = 64, unsigned flags = 0);
+
+        //! destroy io_uring
+        ~IoUring( );
+
+        /*! \brief get the next free submission queue entry
+         *
+         * The entry is zero initialized.
+         * Returns nullptr if the submission queue is full.
+         */
+        io_uring_sqe* get_sqe( ) noexcept;
+
+        /*! \brief submit all entries acquired by get_sqe()
+         *
+         * attributes:
+         *   wait_nr: number of completions to wait for
+         * possible_throws:
+         *   std::system_error: a system call failed
+         *
+         * returns the number of submitted entries
+         */
+        unsigned submit(unsigned wait_nr = 0);
+
+        /*! \brief get next completion queue entry
+         *
+         * Returns nullptr if no completion is available.
+         * The entry must be released by cqe_seen().
+         */
+        io_uring_cqe* peek_cqe( ) noexcept;
+
+        /*! \brief wait for next completion queue entry
+         *
+         * Pending submissions are submitted.
+         * The entry must be released by cqe_seen().
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        io_uring_cqe* wait_cqe( );
+
+        //! release the completion queue entry returned by peek_cqe() or wait_cqe()
+        void cqe_seen( ) noexcept;
+
+        //! get io_uring file descriptor
+        inline int get_fd( ) const noexcept;
+
+        //! get features reported by the kernel
+        inline unsigned get_features( ) const noexcept;
+
+        //! copying not allowed
+        IoUring(const IoUring &other) = delete;
+        //! copying not allowed
+        IoUring& operator=(const IoUring &other) = delete;
+
+        //! move this object
+        IoUring(IoUring &&other) noexcept;
+        //! move this object
+        IoUring& operator=(IoUring &&other) noexcept;
+};
+
+inline int IoUring::get_fd( ) const noexcept
+{
+    return ring_fd;
+}
+
+inline unsigned IoUring::get_features( ) const noexcept
+{
+    return features;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,127 @@
+/*
+ * \file IoUringSignalSource.cpp
+ * \brief Source file de::Koesling::Signal::IoUringSignalSource
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * requires linux 5.6 or higher (5.13 or higher for multishot mode)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "IoUringSignalSource.hpp"
+#include "common_header/sysexcept.hpp"
+#include <cerrno>
+#include <poll.h>
+#include <stdexcept>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+IoUringSignalSource::IoUringSignalSource(const sigset_t &signals, std::uint64_t user_data, std::size_t max_records,
+        bool multishot, std::size_t max_batches) :
+        signal_fd(signals, SFD_NONBLOCK | SFD_CLOEXEC, true),
+        user_data(user_data),
+        multishot(multishot),
+        armed(false),
+        pending(false),
+        max_records(max_records),
+        read_half(0),
+        result_half(1),
+        reader(max_records, max_batches)
+{
+    if (!multishot) records.resize(2 * max_records);
+}
+
+void IoUringSignalSource::arm(IoUring &ring)
+{
+    if (armed) return;
+    submit_request(ring);
+}
+
+void IoUringSignalSource::submit_request(IoUring &ring)
+{
+    io_uring_sqe *sqe = ring.get_sqe( );
+    if (sqe == nullptr) throw std::runtime_error("io_uring submission queue full.");
+
+    sqe->fd = signal_fd.get_fd( );
+    sqe->user_data = user_data;
+
+    if (multishot)
+    {
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->poll32_events = POLLIN;
+        sqe->len = IORING_POLL_ADD_MULTI;
+    }
+    else
+    {
+        sqe->opcode = IORING_OP_READ;
+        sqe->addr = reinterpret_cast<std::uint64_t>(records.data( ) + read_half * max_records);
+        sqe->len = static_cast<std::uint32_t>(max_records * sizeof(signalfd_siginfo));
+        sqe->off = static_cast<std::uint64_t>(-1);	// signalfd is not seekable
+    }
+
+    armed = true;
+}
+
+SignalEventSpan IoUringSignalSource::handle(IoUring &ring, const io_uring_cqe &cqe)
+{
+    SignalEventSpan events { nullptr, 0 };
+    const bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+
+    if (multishot && cqe.res == -EINVAL)
+    {
+        // multishot poll not supported --> fall back to single read requests
+        armed = false;
+        multishot = false;
+        records.resize(2 * max_records);
+        submit_request(ring);
+        return events;
+    }
+
+    if (cqe.res < 0 && cqe.res != -EAGAIN && cqe.res != -EINTR && cqe.res != -ECANCELED)
+    {
+        armed = false;
+        sysexcept(true, multishot ? "io_uring poll" : "io_uring read", -cqe.res);
+    }
+
+    if (multishot)
+    {
+        // the poll does not fire again for pending records --> read them (bounded, see read_pending())
+        if (cqe.res > 0) events = reader.drain(signal_fd, pending);
+    }
+    else
+    {
+        // the buffer half of the completed read holds the result
+        result_half = read_half;
+        read_half ^= 1;
+        if (cqe.res > 0)
+            events = reader.convert(records.data( ) + result_half * max_records,
+                    static_cast<std::size_t>(cqe.res) / sizeof(signalfd_siginfo));
+    }
+
+    // single shot request or terminated multishot request --> resubmit
+    if (!multishot || !more)
+    {
+        armed = false;
+        submit_request(ring);
+    }
+
+    return events;
+}
+
+SignalEventSpan IoUringSignalSource::read_pending( )
+{
+    if (!pending) return SignalEventSpan { nullptr, 0 };
+    return reader.drain(signal_fd, pending);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
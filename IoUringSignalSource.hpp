@@ -0,0 +1,191 @@
+/*
+ * \file IoUringSignalSource.hpp
+ * \brief Header file de::Koesling::Signal::IoUringSignalSource
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * requires linux 5.6 or higher (5.13 or higher for multishot mode)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "IoUring.hpp"
+#include "SignalFd.hpp"
+#include "SignalFdReader.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Signal source for io_uring based event loops
+ *
+ * Signals are accepted via a signalfd which is read through an io_uring.
+ * Signal events therefore arrive as completion queue entries in the same
+ * completion loop as all other I/O of the ring.
+ *
+ * In multishot mode a multishot poll request (IORING_POLL_ADD_MULTI) is
+ * submitted once and the signalfd is drained on every completion (read
+ * until no signal is pending, max_records records per read, at most
+ * max_batches reads). The poll does not complete again for signals that
+ * are still pending after the limit: they are read by read_pending() as
+ * long as has_pending() is set.
+ * If the kernel does not support multishot poll, the source falls back to
+ * single read requests that are resubmitted after each completion.
+ *
+ * usage:
+ *   source.arm(ring);
+ *   for (;;) {
+ *       io_uring_cqe *cqe = ring.wait_cqe();
+ *       if (source.owns(*cqe)) {
+ *           for (const SignalEvent &event : source.handle(ring, *cqe))
+ *               // process event
+ *       }
+ *       while (source.has_pending())  // may be interleaved with other work
+ *           for (const SignalEvent &event : source.read_pending())
+ *               // process event
+ *       ring.cqe_seen();
+ *   }
+ */
+class IoUringSignalSource
+{
+    private:
+        //! signalfd that is read via the io_uring
+        SignalFd signal_fd;
+
+        //! user_data of all requests submitted by this source
+        std::uint64_t user_data;
+
+        //! use multishot poll requests
+        bool multishot;
+
+        //! a request of this source is pending
+        bool armed;
+
+        //! the last drain of the signalfd stopped at its limit (multishot mode)
+        bool pending;
+
+        //! maximum number of records per read
+        std::size_t max_records;
+
+        /*! \brief record buffer for single read requests
+         *
+         * double buffered: one half is owned by the pending read request,
+         * the other half holds the result of the last completion.
+         */
+        std::vector<signalfd_siginfo> records;
+
+        //! buffer half used by the pending read request
+        std::size_t read_half;
+
+        //! buffer half that holds the result of the last completion
+        std::size_t result_half;
+
+        //! converts records to events (and drains the signalfd in multishot mode)
+        SignalFdReader reader;
+
+        //! submit request (multishot poll or single read)
+        void submit_request(IoUring &ring);
+
+    public:
+        /*! \brief create io_uring signal source
+         *
+         * The signals are blocked in the calling thread.
+         *
+         * attributes:
+         *   signals     : signals which are accepted by this source
+         *   user_data   : user_data that identifies the completion queue
+         *                 entries of this source
+         *   max_records : maximum number of records per read (single read
+         *                 mode: per completion)
+         *   multishot   : use multishot poll if supported by the kernel
+         *   max_batches : maximum number of reads per completion or
+         *                 read_pending() call (multishot mode)
+         * possible_throws:
+         *   std::system_error   : a system call failed
+         *   std::invalid_argument: max_records or max_batches is 0
+         */
+        IoUringSignalSource(const sigset_t &signals, std::uint64_t user_data, std::size_t max_records = 16,
+                bool multishot = true, std::size_t max_batches = 16);
+
+        /*! \brief submit the read request to the ring
+         *
+         * Must be called once before the first completion is expected.
+         * The request is submitted with the next call of ring.submit().
+         *
+         * possible_throws:
+         *   std::runtime_error: submission queue full
+         */
+        void arm(IoUring &ring);
+
+        //! check if a completion queue entry belongs to this source
+        inline bool owns(const io_uring_cqe &cqe) const noexcept;
+
+        /*! \brief handle a completion queue entry of this source
+         *
+         * The request is resubmitted if required.
+         * Returns the received events. The span stays valid until the next
+         * call of handle().
+         *
+         * possible_throws:
+         *   std::system_error : the request failed
+         *   std::runtime_error: submission queue full
+         */
+        SignalEventSpan handle(IoUring &ring, const io_uring_cqe &cqe);
+
+        /*! \brief check if signals may still be pending after handle() or read_pending()
+         *
+         * (the drain of the signalfd stopped at max_batches reads or at a
+         * read error)
+         */
+        inline bool has_pending( ) const noexcept;
+
+        /*! \brief continue draining the signalfd (multishot mode)
+         *
+         * Reads at most max_batches times. Returns the received events. The
+         * span stays valid until the next call of handle() or read_pending().
+         *
+         * possible_throws:
+         *   std::system_error: a read failed
+         */
+        SignalEventSpan read_pending( );
+
+        //! check if multishot mode is used
+        inline bool is_multishot( ) const noexcept;
+
+        //! get underlying signalfd
+        inline const SignalFd& get_signal_fd( ) const noexcept;
+};
+
+inline bool IoUringSignalSource::owns(const io_uring_cqe &cqe) const noexcept
+{
+    return cqe.user_data == user_data;
+}
+
+inline bool IoUringSignalSource::has_pending( ) const noexcept
+{
+    return pending;
+}
+
+inline bool IoUringSignalSource::is_multishot( ) const noexcept
+{
+    return multishot;
+}
+
+inline const SignalFd& IoUringSignalSource::get_signal_fd( ) const noexcept
+{
+    return signal_fd;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
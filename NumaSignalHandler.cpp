@@ -0,0 +1,360 @@
+/*
+ * \file NumaSignalHandler.cpp
+ * \brief Source file de::Koesling::Signal::NumaSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "NumaSignalHandler.hpp"
+#include "Futex.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <sys/syscall.h>
+#include <sysexits.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! maximum number of events taken from one queue before the next queue is served
+static constexpr std::size_t DRAIN_BURST = 64;
+
+//! sysfs directory of the NUMA nodes
+static const std::string NODE_DIR = "/sys/devices/system/node/";
+
+//! read first line of a file (empty string if it does not exist)
+static std::string read_line(const std::string &path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+NumaSignalHandler::Shard::Shard(std::size_t capacity) :
+        queue(capacity),
+        parked(false)
+{ }
+
+NumaSignalHandler::Shard::Shard(std::size_t capacity, HugePageArena &arena) :
+        queue(capacity, arena),
+        parked(false)
+{ }
+
+NumaSignalHandler::ShardDeleter::ShardDeleter(bool arena_memory) noexcept :
+        arena_memory(arena_memory)
+{ }
+
+void NumaSignalHandler::ShardDeleter::operator()(Shard *shard) const noexcept
+{
+    shard->~Shard( );
+    if (!arena_memory) free(shard);
+}
+
+NumaSignalHandler::NumaSignalHandler(int signal_number, SignalEventHandler_t handler_function, Sharding sharding,
+        std::size_t queue_capacity, int sa_flags, sigset_t *blocked_signals) :
+        signal_number(signal_number),
+        handler_function(std::move(handler_function)),
+        wakeups(0),
+        stop(false),
+        signal_handler(signal_number, SignalTrampoline::handler, sa_flags, blocked_signals)
+{
+    if (!this->handler_function)
+        throw std::invalid_argument("Unable to establish a signal handler with no handler function.");
+
+    const long cpu_count = sysconf(_SC_NPROCESSORS_CONF);
+    sysexcept(cpu_count < 1, "sysconf", errno);
+    cpu_queue.assign(static_cast<std::size_t>(cpu_count), 0);
+
+    // cpus of each queue
+    std::vector<std::vector<unsigned>> cpus;
+    if (sharding == Sharding::CPU)
+    {
+        cpus.resize(cpu_queue.size( ));
+        for (std::size_t i = 0; i < cpu_queue.size( ); ++i)
+        {
+            cpu_queue[i] = static_cast<unsigned>(i);
+            cpus[i].push_back(static_cast<unsigned>(i));
+        }
+    }
+    else
+    {
+        cpus.resize(node_count( ));
+        for (unsigned node = 0; node < cpus.size( ); ++node)
+        {
+            // offline or memory only nodes have no (or an empty) cpu list
+            const std::string list = read_line(NODE_DIR + "node" + std::to_string(node) + "/cpulist");
+            for (unsigned cpu : parse_list(list))
+                if (cpu < cpu_queue.size( ))
+                {
+                    cpu_queue[cpu] = node;
+                    cpus[node].push_back(cpu);
+                }
+        }
+    }
+
+    create_queues(cpus, queue_capacity);
+
+    SignalTrampoline::attach(signal_number, this);
+
+    try
+    {
+        consumer = std::thread(&NumaSignalHandler::consume, this);
+    }
+    catch (...)
+    {
+        SignalTrampoline::detach(signal_number, this);
+        throw;
+    }
+}
+
+void NumaSignalHandler::create_queues(const std::vector<std::vector<unsigned>> &cpus, std::size_t queue_capacity)
+{
+    queues.reserve(cpus.size( ));
+
+    // the pages of a queue are placed on the node of the thread that touches them first
+    // --> create every queue in a thread that runs on a cpu of its node
+    const bool huge_pages = HugePageArena::get_library( ) != nullptr;
+    const std::size_t shard_bytes = sizeof(Shard) + alignof(Shard) + SignalEventQueue::memory_size(queue_capacity)
+            + 64;
+    unsigned arena_node = 0;
+
+    std::exception_ptr error;
+    std::thread creator([&]( ) {
+        try
+        {
+            for (const auto &queue_cpus : cpus)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (unsigned cpu : queue_cpus)
+                    if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+
+                // not allowed to run on the node (e.g. cpuset) --> allocate anywhere
+                if (CPU_COUNT(&set) != 0) pthread_setaffinity_np(pthread_self( ), sizeof(set), &set);
+
+                if (huge_pages)
+                {
+                    // the library arena is placed on one node --> arena per node (prefaulted by this thread)
+                    unsigned cpu = 0;
+                    unsigned node = 0;
+                    syscall(SYS_getcpu, &cpu, &node, nullptr);
+                    if (arenas.empty( ) || node != arena_node
+                            || arenas.back( )->get_size( ) - arenas.back( )->get_used( ) < shard_bytes)
+                    {
+                        arenas.emplace_back(new HugePageArena(shard_bytes));
+                        arena_node = node;
+                    }
+
+                    HugePageArena &arena = *arenas.back( );
+                    void *memory = arena.allocate(sizeof(Shard), alignof(Shard));
+                    queues.emplace_back(new (memory) Shard(queue_capacity, arena), ShardDeleter(true));
+                    continue;
+                }
+
+                // operator new does not support over-aligned types before C++17
+                void *memory = nullptr;
+                if (posix_memalign(&memory, alignof(Shard), sizeof(Shard)) != 0) throw std::bad_alloc( );
+                try
+                {
+                    queues.emplace_back(new (memory) Shard(queue_capacity));
+                }
+                catch (...)
+                {
+                    free(memory);
+                    throw;
+                }
+            }
+        }
+        catch (...)
+        {
+            error = std::current_exception( );
+        }
+    });
+    creator.join( );
+
+    if (error) std::rethrow_exception(error);
+}
+
+NumaSignalHandler::~NumaSignalHandler( )
+{
+    // restore previous handler before the sink is detached
+    if (signal_handler.is_established( ))
+    {
+        try
+        {
+            signal_handler.revoke( );
+        }
+        catch (const std::exception &e) // system call failed
+        {
+            destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+        }
+    }
+
+    SignalTrampoline::detach(signal_number, this);
+
+    stop.store(true);
+    wakeups.fetch_add(1);
+    futex_wake(wakeups);
+    consumer.join( );
+}
+
+void NumaSignalHandler::on_signal(int, siginfo_t *info, void*) noexcept
+{
+    SignalEvent event;
+    to_signal_event(*info, monotonic_ns( ), event);
+
+    // sched_getcpu is served by rseq / vdso (no system call)
+    const int cpu = sched_getcpu( );
+    const unsigned index = cpu >= 0 && static_cast<std::size_t>(cpu) < cpu_queue.size( ) ?
+            cpu_queue[static_cast<std::size_t>(cpu)] : 0;
+
+    Shard &shard = *queues[index];
+    shard.queue.push(event);
+
+    // pairs with the fence of the parking consumer: either it sees the event or we see the flag
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (shard.parked.load(std::memory_order_relaxed) && shard.parked.exchange(false)) wake( );
+}
+
+void NumaSignalHandler::wake( ) noexcept
+{
+    wakeups.fetch_add(1, std::memory_order_release);
+    futex_wake(wakeups, 1);
+}
+
+bool NumaSignalHandler::drain(std::size_t &next)
+{
+    bool processed = false;
+
+    bool found;
+    do
+    {
+        found = false;
+        for (std::size_t i = 0; i < queues.size( ); ++i)
+        {
+            SignalEventQueue &queue = queues[(next + i) % queues.size( )]->queue;
+            SignalEvent event;
+            for (std::size_t n = 0; n < DRAIN_BURST && queue.pop(event); ++n)
+            {
+                found = true;
+                try
+                {
+                    handler_function(event);
+                }
+                catch (const std::exception &e)
+                {
+                    SignalHandler::get_error_stream( ) << "NumaSignalHandler: handler function failed: "
+                            << e.what( ) << std::endl;
+                }
+                catch (...)
+                {
+                    SignalHandler::get_error_stream( )
+                            << "NumaSignalHandler: handler function failed: unknown exception" << std::endl;
+                }
+            }
+        }
+        next = (next + 1) % queues.size( );
+        processed = processed || found;
+    } while (found);
+
+    return processed;
+}
+
+void NumaSignalHandler::consume( )
+{
+    std::size_t next = 0;
+
+    for (;;)
+    {
+        drain(next);
+        if (stop.load( )) break;
+
+        // park: announce it in every shard, then check the queues again
+        const std::uint32_t ticket = wakeups.load(std::memory_order_acquire);
+        for (auto &shard : queues)
+            shard->parked.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (!drain(next) && !stop.load( ))
+        {
+            while (futex_wait(wakeups, ticket) == -1 && errno == EINTR)
+                ;
+        }
+
+        for (auto &shard : queues)
+            shard->parked.store(false, std::memory_order_relaxed);
+    }
+}
+
+std::uint64_t NumaSignalHandler::get_dropped( ) const noexcept
+{
+    std::uint64_t dropped = 0;
+    for (const auto &shard : queues)
+        dropped += shard->queue.get_dropped( );
+    return dropped;
+}
+
+unsigned NumaSignalHandler::node_count( )
+{
+    const std::vector<unsigned> nodes = parse_list(read_line(NODE_DIR + "possible"));
+
+    unsigned count = 1;
+    for (unsigned node : nodes)
+        if (node + 1 > count) count = node + 1;
+    return count;
+}
+
+std::vector<unsigned> NumaSignalHandler::parse_list(const std::string &list)
+{
+    std::vector<unsigned> values;
+
+    std::size_t pos = 0;
+    while (pos < list.size( ))
+    {
+        std::size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size( );
+        const std::string range = list.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (range.empty( ) || range == "\n") continue;
+
+        try
+        {
+            const std::size_t dash = range.find('-');
+            const unsigned first = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+            const unsigned last = dash == std::string::npos ? first :
+                    static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+            if (last < first) throw std::invalid_argument("range");
+            for (unsigned value = first; value <= last; ++value)
+                values.push_back(value);
+        }
+        catch (const std::exception&)
+        {
+            throw std::invalid_argument("NumaSignalHandler: malformed cpu / node list '" + list + "'.");
+        }
+    }
+
+    return values;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
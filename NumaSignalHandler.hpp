@@ -0,0 +1,216 @@
+/*
+ * \file NumaSignalHandler.hpp
+ * \brief Header file de::Koesling::Signal::NumaSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "HugePageArena.hpp"
+#include "SignalHandler.hpp"
+#include "SignalEvent.hpp"
+#include "SignalEventQueue.hpp"
+#include "SignalThreadConfig.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Signal handler with one event queue per NUMA node (or cpu)
+ *
+ * If many threads on different sockets receive signals, a single shared
+ * queue bounces its cache lines between the sockets. The installed
+ * trampoline of this handler pushes the event into the queue of the node
+ * (or cpu) it runs on (sched_getcpu). A consumer thread drains the queues
+ * round robin and calls the handler function in normal thread context.
+ *
+ * Each queue is allocated and initialized by a thread running on its node
+ * (first touch), and has its own wakeup flag. If the library arena exists
+ * (see HugePageArena::init_library()), the queues are placed in huge page
+ * arenas that are created on their node instead of the shared arena. While the consumer is busy,
+ * the delivery path only writes node local cache lines. The shared futex
+ * word is written only to wake the parked consumer.
+ *
+ * The order of events is only preserved per queue.
+ */
+class NumaSignalHandler : private SignalSink
+{
+    public:
+        //! queue selection
+        enum class Sharding
+        {
+            NODE, //!< one queue per NUMA node
+            CPU   //!< one queue per cpu
+        };
+
+    private:
+        //! event queue of a node (or cpu)
+        struct Shard
+        {
+            //! event queue
+            SignalEventQueue queue;
+
+            //! consumer is parked (set by the consumer, cleared by the producers of this shard)
+            alignas(64) std::atomic<bool> parked;
+
+            explicit Shard(std::size_t capacity);
+            Shard(std::size_t capacity, HugePageArena &arena);
+        };
+
+        //! destroy and free a cache line aligned shard
+        struct ShardDeleter
+        {
+            //! shard is located in an arena (released with the arena)
+            bool arena_memory;
+
+            explicit ShardDeleter(bool arena_memory = false) noexcept;
+            void operator()(Shard *shard) const noexcept;
+        };
+
+        //! signal number
+        int signal_number;
+
+        //! handler function
+        SignalEventHandler_t handler_function;
+
+        //! node local huge page arenas (only if the library arena exists)
+        std::vector<std::unique_ptr<HugePageArena>> arenas;
+
+        //! event queues
+        std::vector<std::unique_ptr<Shard, ShardDeleter>> queues;
+
+        //! queue index per cpu
+        std::vector<unsigned> cpu_queue;
+
+        //! futex word of the parked consumer (incremented by every wakeup)
+        std::atomic<std::uint32_t> wakeups;
+
+        //! stop the consumer thread
+        std::atomic<bool> stop;
+
+        //! consumer thread
+        std::thread consumer;
+
+        //! installed trampoline
+        SignalHandler signal_handler;
+
+        //! capture event (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+        //! consumer thread
+        void consume( );
+
+        //! process up to DRAIN_BURST events of every queue until all queues are empty
+        bool drain(std::size_t &next);
+
+        //! wake the consumer thread (async-signal-safe)
+        void wake( ) noexcept;
+
+        //! allocate the queues on their nodes (cpus: cpus of each queue)
+        void create_queues(const std::vector<std::vector<unsigned>> &cpus, std::size_t queue_capacity);
+
+    public:
+        /*! \brief init NumaSignalHandler
+         *
+         * attributes:
+         *   signal_number   : signal which will be handled by this handler
+         *   handler_function: function that is called for every event
+         *   sharding        : one queue per node or per cpu
+         *   queue_capacity  : capacity of each queue (further events are dropped)
+         *   sa_flags        : see man sigaction (sa_flags)
+         *   blocked_signals : see man sigaction (sa_mask)
+         * possible_throws:
+         *   std::invalid_argument: invalid argument
+         *   std::logic_error     : another sink is attached to the signal
+         *   std::system_error    : a system call failed
+         */
+        NumaSignalHandler(int signal_number, SignalEventHandler_t handler_function,
+                Sharding sharding = Sharding::NODE, std::size_t queue_capacity = 1024, int sa_flags = SA_RESTART,
+                sigset_t *blocked_signals = nullptr);
+
+        //! revoke handler, process all captured events and stop consumer thread
+        ~NumaSignalHandler( );
+
+        /*! \brief arm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        inline void establish( );
+
+        /*! \brief disarm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         *   std::logic_error : major programming error
+         */
+        inline void revoke( );
+
+        //! get number of queues
+        inline std::size_t get_queue_count( ) const noexcept;
+
+        //! get number of events dropped because a queue was full
+        std::uint64_t get_dropped( ) const noexcept;
+
+        /*! \brief set affinity and scheduling of the consumer thread
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        inline void configure_consumer(const SignalThreadConfig &config);
+
+        //! get number of possible NUMA nodes (1 if unknown)
+        static unsigned node_count( );
+
+        /*! \brief parse a linux cpu / node list (e.g. "0-3,8,10-11")
+         *
+         * possible_throws:
+         *   std::invalid_argument: malformed list
+         */
+        static std::vector<unsigned> parse_list(const std::string &list);
+
+        //! copying not allowed
+        NumaSignalHandler(const NumaSignalHandler &other) = delete;
+        //! copying not allowed
+        NumaSignalHandler& operator=(const NumaSignalHandler &other) = delete;
+};
+
+inline void NumaSignalHandler::establish( )
+{
+    signal_handler.establish( );
+}
+
+inline void NumaSignalHandler::revoke( )
+{
+    signal_handler.revoke( );
+}
+
+inline std::size_t NumaSignalHandler::get_queue_count( ) const noexcept
+{
+    return queues.size( );
+}
+
+inline void NumaSignalHandler::configure_consumer(const SignalThreadConfig &config)
+{
+    config.apply(consumer.native_handle( ));
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
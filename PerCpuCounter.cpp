@@ -0,0 +1,86 @@
+/*
+ * \file PerCpuCounter.cpp
+ * \brief Source file de::Koesling::Signal::PerCpuCounter
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * uses restartable sequences (linux 4.18, glibc 2.35) on x86_64 if available
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "PerCpuCounter.hpp"
+#include "HugePageArena.hpp"
+#include <new>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! next per thread shard
+static std::atomic<unsigned> next_thread_shard(0);
+
+//! per thread shard index + 1 (0: not assigned); initial-exec: async-signal-safe access
+static thread_local unsigned thread_shard __attribute__((tls_model("initial-exec"))) = 0;
+
+PerCpuCounter::PerCpuCounter( ) :
+        shards(nullptr),
+        cpu_count(1)
+{
+    const long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    if (cpus > 1) cpu_count = static_cast<std::size_t>(cpus);
+
+    // incremented by signal handlers: library arena if it exists
+    void *memory = HugePageArena::allocate_handler_memory(2 * cpu_count * sizeof(Shard), alignof(Shard));
+
+    shards = static_cast<Shard*>(memory);
+    for (std::size_t i = 0; i < 2 * cpu_count; ++i)
+        new (&shards[i]) Shard { { 0 } };
+}
+
+PerCpuCounter::~PerCpuCounter( )
+{
+    HugePageArena::release_handler_memory(shards);
+}
+
+void PerCpuCounter::thread_add(std::uint64_t value) noexcept
+{
+    unsigned shard = thread_shard;
+    if (shard == 0)
+    {
+        shard = next_thread_shard.fetch_add(1, std::memory_order_relaxed) % cpu_count + 1;
+        thread_shard = shard;
+    }
+
+    // separate shards: never mixed with the non-atomic rseq adds
+    shards[cpu_count + (shard - 1) % cpu_count].value.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::uint64_t PerCpuCounter::get( ) const noexcept
+{
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < 2 * cpu_count; ++i)
+        sum += shards[i].value.load(std::memory_order_relaxed);
+    return sum;
+}
+
+void PerCpuCounter::reset( ) noexcept
+{
+    for (std::size_t i = 0; i < 2 * cpu_count; ++i)
+        shards[i].value.store(0, std::memory_order_relaxed);
+}
+
+bool PerCpuCounter::uses_rseq( ) noexcept
+{
+    return rseq_area( ) != nullptr;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
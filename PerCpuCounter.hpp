@@ -0,0 +1,180 @@
+/*
+ * \file PerCpuCounter.hpp
+ * \brief Header file de::Koesling::Signal::PerCpuCounter
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * uses restartable sequences (linux 4.18, glibc 2.35) on x86_64 if available
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// rseq registration of glibc (weak: not available with older versions)
+extern "C" {
+extern const std::ptrdiff_t __rseq_offset __attribute__((weak));
+extern const unsigned int __rseq_size __attribute__((weak));
+}
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Counter with one cache line per cpu
+ *
+ * add() increments the shard of the current cpu with a plain (not locked)
+ * add instruction inside a restartable sequence: if the thread is
+ * preempted, migrated or interrupted by a signal before the add is
+ * committed, the kernel aborts the sequence and the add is retried.
+ * Counting therefore never bounces cache lines between cpus.
+ *
+ * If restartable sequences are not available (not x86_64, old kernel or
+ * glibc, rseq disabled), each thread uses a shard selected at its first
+ * add() and updates it with a relaxed atomic add.
+ *
+ * add() is async-signal-safe. get() sums all shards.
+ */
+class PerCpuCounter
+{
+    private:
+        //! counter shard (one cache line)
+        struct alignas(64) Shard
+        {
+            std::atomic<std::uint64_t> value;
+        };
+
+        //! rseq area of the kernel abi (struct rseq)
+        struct RseqArea
+        {
+            std::uint32_t cpu_id_start;
+            std::uint32_t cpu_id;
+            std::uint64_t rseq_cs;
+            std::uint32_t flags;
+        };
+
+        //! shards (cpu_count rseq shards followed by cpu_count per thread shards)
+        Shard *shards;
+
+        //! number of cpus
+        std::size_t cpu_count;
+
+        //! get the rseq area of the calling thread (nullptr: not registered)
+        static inline RseqArea* rseq_area( ) noexcept;
+
+        //! add to the shard of the current cpu (returns false if aborted)
+        static inline bool rseq_add(RseqArea *area, Shard *shard_base, std::uint64_t value) noexcept;
+
+        //! fallback: add to the shard of the calling thread
+        void thread_add(std::uint64_t value) noexcept;
+
+    public:
+        /*! \brief create counter
+         *
+         * possible_throws:
+         *   std::bad_alloc: out of memory
+         */
+        PerCpuCounter( );
+
+        //! destroy counter
+        ~PerCpuCounter( );
+
+        //! add value (async-signal-safe)
+        inline void add(std::uint64_t value = 1) noexcept;
+
+        //! get sum of all shards
+        std::uint64_t get( ) const noexcept;
+
+        //! set all shards to 0 (concurrent adds may be lost)
+        void reset( ) noexcept;
+
+        //! check if add() uses restartable sequences in the calling thread
+        static bool uses_rseq( ) noexcept;
+
+        //! copying not allowed
+        PerCpuCounter(const PerCpuCounter &other) = delete;
+        //! copying not allowed
+        PerCpuCounter& operator=(const PerCpuCounter &other) = delete;
+};
+
+inline PerCpuCounter::RseqArea* PerCpuCounter::rseq_area( ) noexcept
+{
+#if defined(__x86_64__)
+    if (&__rseq_size == nullptr || __rseq_size == 0) return nullptr;
+
+    char *thread_pointer;
+    asm ("mov %%fs:0, %0" : "=r" (thread_pointer));
+    return reinterpret_cast<RseqArea*>(thread_pointer + __rseq_offset);
+#else
+    return nullptr;
+#endif
+}
+
+inline bool PerCpuCounter::rseq_add(RseqArea *area, Shard *shard_base, std::uint64_t value) noexcept
+{
+#if defined(__x86_64__)
+    const std::uint32_t cpu = area->cpu_id_start;
+    std::uint64_t *counter = reinterpret_cast<std::uint64_t*>(&shard_base[cpu].value);
+
+    // critical section descriptor (struct rseq_cs), abort handler preceded by RSEQ_SIG
+    asm volatile goto (
+            ".pushsection __rseq_cs, \"aw\"\n\t"
+            ".balign 32\n\t"
+            "3:\n\t"
+            ".long 0x0, 0x0\n\t"
+            ".quad 1f, (2f - 1f), 4f\n\t"
+            ".popsection\n\t"
+            "leaq 3b(%%rip), %%rax\n\t"
+            "movq %%rax, %[rseq_cs]\n\t"
+            "1:\n\t"
+            "cmpl %[cpu_id], %[cpu]\n\t"
+            "jnz %l[abort]\n\t"
+            "addq %[value], (%[counter])\n\t"
+            "2:\n\t"
+            ".pushsection __rseq_failure, \"ax\"\n\t"
+            ".byte 0x0f, 0xb9, 0x3d\n\t"
+            ".long 0x53053053\n\t"
+            "4:\n\t"
+            "jmp %l[abort]\n\t"
+            ".popsection\n\t"
+            :
+            : [cpu_id] "m" (area->cpu_id), [cpu] "r" (cpu), [rseq_cs] "m" (area->rseq_cs),
+              [counter] "r" (counter), [value] "er" (value)
+            : "memory", "cc", "rax"
+            : abort);
+    return true;
+
+abort:
+    return false;
+#else
+    static_cast<void>(area);
+    static_cast<void>(shard_base);
+    static_cast<void>(value);
+    return false;
+#endif
+}
+
+inline void PerCpuCounter::add(std::uint64_t value) noexcept
+{
+    RseqArea *area = rseq_area( );
+    if (area != nullptr && area->cpu_id_start < cpu_count)
+    {
+        for (int attempt = 0; attempt < 8; ++attempt)
+            if (rseq_add(area, shards, value)) return;
+    }
+
+    thread_add(value);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
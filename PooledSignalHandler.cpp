@@ -0,0 +1,148 @@
+/*
+ * \file PooledSignalHandler.cpp
+ * \brief Source file de::Koesling::Signal::PooledSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "PooledSignalHandler.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <stdexcept>
+#include <sysexits.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+PooledSignalHandler::PooledSignalHandler(int signal_number, WorkStealingPool &pool,
+        SignalEventHandler_t handler_function, SignalEventKey_t key_function, std::size_t queue_capacity,
+        int sa_flags, sigset_t *blocked_signals) :
+        signal_number(signal_number),
+        pool(pool),
+        handler_function(std::move(handler_function)),
+        key_function(std::move(key_function)),
+        queue(queue_capacity),
+        stop(false),
+        in_flight(0),
+        signal_handler(signal_number, SignalTrampoline::handler, sa_flags, blocked_signals)
+{
+    if (!this->handler_function)
+        throw std::invalid_argument("Unable to establish a signal handler with no handler function.");
+
+    int temp = sem_init(&semaphore, 0, 0);
+    sysexcept(temp != 0, "sem_init", errno);
+
+    try
+    {
+        SignalTrampoline::attach(signal_number, this);
+    }
+    catch (...)
+    {
+        sem_destroy(&semaphore);
+        throw;
+    }
+
+    try
+    {
+        collector = std::thread(&PooledSignalHandler::collect, this);
+    }
+    catch (...)
+    {
+        SignalTrampoline::detach(signal_number, this);
+        sem_destroy(&semaphore);
+        throw;
+    }
+}
+
+PooledSignalHandler::~PooledSignalHandler( )
+{
+    // restore previous handler before the sink is detached
+    if (signal_handler.is_established( ))
+    {
+        try
+        {
+            signal_handler.revoke( );
+        }
+        catch (const std::exception &e) // system call failed
+        {
+            destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+        }
+    }
+
+    SignalTrampoline::detach(signal_number, this);
+
+    stop.store(true);
+    sem_post(&semaphore);
+    collector.join( );
+    sem_destroy(&semaphore);
+}
+
+void PooledSignalHandler::on_signal(int, siginfo_t *info, void*) noexcept
+{
+    SignalEvent event;
+    to_signal_event(*info, monotonic_ns( ), event);
+    if (queue.push(event)) sem_post(&semaphore);
+}
+
+void PooledSignalHandler::collect( )
+{
+    for (;;)
+    {
+        while (sem_wait(&semaphore) == -1 && errno == EINTR)
+            ;
+
+        SignalEvent event;
+        while (queue.pop(event))
+        {
+            {
+                std::lock_guard<std::mutex> lock(in_flight_mutex);
+                ++in_flight;
+            }
+
+            if (key_function)
+                pool.submit(key_function(event), [this, event]( ) { run_handler(event); });
+            else
+                pool.submit([this, event]( ) { run_handler(event); });
+        }
+
+        if (stop.load( )) break;
+    }
+
+    // handler tasks must not outlive this object
+    std::unique_lock<std::mutex> lock(in_flight_mutex);
+    in_flight_condition.wait(lock, [this]( ) { return in_flight == 0; });
+}
+
+void PooledSignalHandler::run_handler(const SignalEvent &event)
+{
+    struct Finish
+    {
+        PooledSignalHandler &handler;
+        ~Finish( )
+        {
+            std::lock_guard<std::mutex> lock(handler.in_flight_mutex);
+            if (--handler.in_flight == 0) handler.in_flight_condition.notify_all( );
+        }
+    } finish { *this };
+
+    handler_function(event);
+}
+
+std::uint64_t PooledSignalHandler::key_by_pid(const SignalEvent &event) noexcept
+{
+    return static_cast<std::uint64_t>(event.pid);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,177 @@
+/*
+ * \file PooledSignalHandler.hpp
+ * \brief Header file de::Koesling::Signal::PooledSignalHandler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalHandler.hpp"
+#include "SignalEventQueue.hpp"
+#include "SignalThreadConfig.hpp"
+#include "SignalTrampoline.hpp"
+#include "WorkStealingPool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <semaphore.h>
+#include <thread>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! serialization key function type for deferred signal events
+typedef std::function<std::uint64_t(const SignalEvent&)> SignalEventKey_t;
+
+/*! \brief Signal handler that executes the handler function in a thread pool
+ *
+ * The installed signal handler (trampoline) only captures the siginfo_t into
+ * a lock free queue and wakes a collector thread. The collector thread
+ * submits one task per event to a WorkStealingPool. Therefore the handler
+ * function runs in parallel and never on the interrupted thread.
+ *
+ * If a key function is specified, events with the same key are processed
+ * serialized (e.g. key_by_pid to serialize all events of one child).
+ *
+ * Note: standard signals (< SIGRTMIN) are merged by the kernel while they
+ * are pending. A SIGCHLD event may therefore stand for several terminated
+ * children (use waitid/waitpid with WNOHANG in the handler function).
+ */
+class PooledSignalHandler : private SignalSink
+{
+    private:
+        //! signal number
+        int signal_number;
+
+        //! thread pool that executes the handler function
+        WorkStealingPool &pool;
+
+        //! handler function
+        SignalEventHandler_t handler_function;
+
+        //! serialization key function (empty: no serialization)
+        SignalEventKey_t key_function;
+
+        //! events captured by the trampoline
+        SignalEventQueue queue;
+
+        //! wakes the collector thread (sem_post is async-signal-safe)
+        sem_t semaphore;
+
+        //! stop the collector thread
+        std::atomic<bool> stop;
+
+        //! number of submitted, but not finished handler tasks
+        std::size_t in_flight;
+        std::mutex in_flight_mutex;
+        std::condition_variable in_flight_condition;
+
+        //! collector thread
+        std::thread collector;
+
+        //! installed trampoline
+        SignalHandler signal_handler;
+
+        //! capture event (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+        //! collector thread
+        void collect( );
+
+        //! execute handler function (pool thread)
+        void run_handler(const SignalEvent &event);
+
+    public:
+        /*! \brief init PooledSignalHandler
+         *
+         * attributes:
+         *   signal_number   : signal which will be handled by this handler
+         *   pool            : thread pool that executes the handler function
+         *   handler_function: function that is called for every event
+         *   key_function    : function that returns the serialization key of
+         *                     an event (nullptr: no serialization)
+         *   queue_capacity  : maximum number of events that are not yet
+         *                     collected (further events are dropped)
+         *   sa_flags        : see man sigaction (sa_flags)
+         *   blocked_signals : see man sigaction (sa_mask)
+         * possible_throws:
+         *   std::invalid_argument: invalid argument
+         *   std::logic_error     : another sink is attached to the signal
+         *   std::system_error    : a system call failed
+         */
+        PooledSignalHandler(int signal_number, WorkStealingPool &pool, SignalEventHandler_t handler_function,
+                SignalEventKey_t key_function = nullptr, std::size_t queue_capacity = 1024,
+                int sa_flags = SA_RESTART, sigset_t *blocked_signals = nullptr);
+
+        //! revoke handler, process all captured events and stop collector thread
+        ~PooledSignalHandler( );
+
+        /*! \brief arm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        inline void establish( );
+
+        /*! \brief disarm the signal Handler
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         *   std::logic_error : major programming error
+         */
+        inline void revoke( );
+
+        //! get number of events dropped because the queue was full
+        inline std::uint64_t get_dropped( ) const noexcept;
+
+        /*! \brief set affinity and scheduling of the collector thread
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        inline void configure_collector(const SignalThreadConfig &config);
+
+        //! key function: serialize events per sending / child process
+        static std::uint64_t key_by_pid(const SignalEvent &event) noexcept;
+
+        //! copying not allowed
+        PooledSignalHandler(const PooledSignalHandler &other) = delete;
+        //! copying not allowed
+        PooledSignalHandler& operator=(const PooledSignalHandler &other) = delete;
+};
+
+inline void PooledSignalHandler::establish( )
+{
+    signal_handler.establish( );
+}
+
+inline void PooledSignalHandler::revoke( )
+{
+    signal_handler.revoke( );
+}
+
+inline std::uint64_t PooledSignalHandler::get_dropped( ) const noexcept
+{
+    return queue.get_dropped( );
+}
+
+inline void PooledSignalHandler::configure_collector(const SignalThreadConfig &config)
+{
+    config.apply(collector.native_handle( ));
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
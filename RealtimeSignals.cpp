@@ -0,0 +1,78 @@
+/*
+ * \file RealtimeSignals.cpp
+ * \brief Source file de::Koesling::Signal::RealtimeSignals
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "RealtimeSignals.hpp"
+#include "SignalRegistry.hpp"
+#include <csignal>
+#include <mutex>
+#include <stdexcept>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! reserved signals
+static bool reserved[_NSIG];
+
+//! protects reserved
+static std::mutex reserved_mutex;
+
+// SIG_DFL uses old style cast --> disable warning for this function
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+static bool has_default_action(int signal_number) noexcept
+{
+    struct sigaction action;
+    if (sigaction(signal_number, nullptr, &action) != 0) return false;
+    return !(action.sa_flags & SA_SIGINFO) && action.sa_handler == SIG_DFL;
+}
+// re-enable old style cast warning
+#pragma GCC diagnostic pop
+
+int RealtimeSignals::reserve( )
+{
+    std::lock_guard<std::mutex> lock(reserved_mutex);
+
+    for (int signal_number = SIGRTMAX; signal_number >= SIGRTMIN; --signal_number)
+    {
+        if (reserved[signal_number]) continue;
+        if (SignalRegistry::is_handled(signal_number)) continue;
+        if (!has_default_action(signal_number)) continue;
+
+        reserved[signal_number] = true;
+        return signal_number;
+    }
+
+    throw std::runtime_error("No free realtime signal available.");
+}
+
+void RealtimeSignals::release(int signal_number) noexcept
+{
+    if (signal_number < SIGRTMIN || signal_number > SIGRTMAX) return;
+
+    std::lock_guard<std::mutex> lock(reserved_mutex);
+    reserved[signal_number] = false;
+}
+
+bool RealtimeSignals::is_reserved(int signal_number) noexcept
+{
+    if (signal_number < SIGRTMIN || signal_number > SIGRTMAX) return false;
+
+    std::lock_guard<std::mutex> lock(reserved_mutex);
+    return reserved[signal_number];
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
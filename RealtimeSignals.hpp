@@ -0,0 +1,50 @@
+/*
+ * \file RealtimeSignals.hpp
+ * \brief Header file de::Koesling::Signal::RealtimeSignals
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Allocation of realtime signals reserved by this library
+ *
+ * Library features that need a private signal (watchdogs, thread kicks,
+ * remote calls, ...) reserve it here. Signals are allocated from SIGRTMAX
+ * downwards, applications usually use SIGRTMIN + n.
+ * Signals that are handled by an established SignalHandler or have a
+ * non-default action are skipped.
+ */
+class RealtimeSignals
+{
+    public:
+        RealtimeSignals( ) = delete;
+
+        /*! \brief reserve a realtime signal
+         *
+         * possible_throws:
+         *   std::runtime_error: no free realtime signal available
+         */
+        static int reserve( );
+
+        //! release a signal reserved by reserve()
+        static void release(int signal_number) noexcept;
+
+        //! check if a signal is reserved by this library
+        static bool is_reserved(int signal_number) noexcept;
+};
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,245 @@
+/*
+ * \file RemoteCall.cpp
+ * \brief Source file de::Koesling::Signal::RemoteCall
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "RemoteCall.hpp"
+#include "Futex.hpp"
+#include "RealtimeSignals.hpp"
+#include "SignalEvent.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <exception>
+#include <stdexcept>
+#include <sysexits.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! convert relative timeout to absolute CLOCK_MONOTONIC deadline
+static struct timespec make_deadline(std::int64_t timeout_ns) noexcept
+{
+    const std::uint64_t end = monotonic_ns( ) + static_cast<std::uint64_t>(timeout_ns);
+    struct timespec deadline;
+    deadline.tv_sec = static_cast<time_t>(end / 1000000000u);
+    deadline.tv_nsec = static_cast<long>(end % 1000000000u);
+    return deadline;
+}
+
+RemoteCall::RemoteCall(std::size_t max_pending) :
+        signal_number(RealtimeSignals::reserve( )),
+        request_count(max_pending),
+        signal_handler(signal_number, SignalTrampoline::handler, SA_RESTART)
+{
+    try
+    {
+        if (max_pending == 0) throw std::invalid_argument("RemoteCall: max_pending must not be 0.");
+
+        requests.reset(new Request[request_count]);
+        for (std::size_t i = 0; i < request_count; ++i)
+            requests[i].state.store(make_state(0, FREE), std::memory_order_relaxed);
+
+        SignalTrampoline::attach(signal_number, this);
+    }
+    catch (...)
+    {
+        RealtimeSignals::release(signal_number);
+        throw;
+    }
+
+    try
+    {
+        signal_handler.establish( );
+    }
+    catch (...)
+    {
+        SignalTrampoline::detach(signal_number, this);
+        RealtimeSignals::release(signal_number);
+        throw;
+    }
+}
+
+RemoteCall::~RemoteCall( )
+{
+    try
+    {
+        // discard signals of abandoned requests that are still queued (e.g. the target thread blocks the
+        // signal): after the release they would terminate the process or reach the next owner of the signal
+        signal_handler.ignore( );
+        signal_handler.revoke( );
+    }
+    catch (const std::exception &e) // system call failed
+    {
+        destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+    }
+    SignalTrampoline::detach(signal_number, this);
+    RealtimeSignals::release(signal_number);
+}
+
+constexpr unsigned RemoteCall::STATE_BITS;
+constexpr std::uint32_t RemoteCall::STATE_MASK;
+
+void RemoteCall::on_signal(int, siginfo_t *info, void*) noexcept
+{
+    // only accept requests of this process (si_value: generation and slot index)
+    if (info->si_code != SI_QUEUE || info->si_pid != getpid( )) return;
+    const std::uint64_t value = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(info->si_value.sival_ptr));
+    const std::size_t index = static_cast<std::size_t>(value & 0xFFFFFFFFu);
+    const std::uint32_t generation = static_cast<std::uint32_t>(value >> 32);
+    if (index >= request_count) return;
+    Request *request = &requests[index];
+
+    // fails for requests of an earlier generation (slot reused)
+    std::uint32_t expected = make_state(generation, PENDING);
+    if (!request->state.compare_exchange_strong(expected, make_state(generation, RUNNING)))
+    {
+        // abandoned before it was started
+        if (expected == make_state(generation, ABANDONED))
+            request->state.compare_exchange_strong(expected, make_state(generation + 1, FREE));
+        return;
+    }
+
+    request->function(request->argument);
+
+    expected = make_state(generation, RUNNING);
+    if (request->state.compare_exchange_strong(expected, make_state(generation, DONE)))
+        futex_wake(request->state);
+    else	// abandoned while running
+        request->state.store(make_state(generation + 1, FREE));
+}
+
+RemoteCall::Request& RemoteCall::acquire( )
+{
+    for (std::size_t i = 0; i < request_count; ++i)
+    {
+        // free slot or request that was abandoned before it started (its signal is ignored by the new generation)
+        std::uint32_t state = requests[i].state.load( );
+        const std::uint32_t generation = state >> STATE_BITS;
+        if ((state & STATE_MASK) == FREE)
+        {
+            if (requests[i].state.compare_exchange_strong(state, make_state(generation, PENDING)))
+                return requests[i];
+        }
+        else if ((state & STATE_MASK) == ABANDONED)
+        {
+            if (requests[i].state.compare_exchange_strong(state, make_state(generation + 1, PENDING)))
+                return requests[i];
+        }
+    }
+    throw std::runtime_error("RemoteCall: too many pending requests.");
+}
+
+void RemoteCall::send(pthread_t thread, Request &request)
+{
+    const std::uint32_t generation = request.state.load( ) >> STATE_BITS;
+    const std::uint64_t index = static_cast<std::uint64_t>(&request - requests.get( ));
+
+    union sigval value;
+    value.sival_ptr = reinterpret_cast<void*>(static_cast<std::uintptr_t>(
+            static_cast<std::uint64_t>(generation) << 32 | index));
+
+    // pthread_sigqueue does not use errno
+    int temp = pthread_sigqueue(thread, signal_number, value);
+    if (temp != 0)
+    {
+        request.state.store(make_state(generation + 1, FREE));
+        sysexcept(true, "pthread_sigqueue", temp);
+    }
+}
+
+bool RemoteCall::wait(Request &request, const struct timespec *deadline)
+{
+    const std::uint32_t generation = request.state.load( ) >> STATE_BITS;
+    for (;;)
+    {
+        const std::uint32_t state = request.state.load( );
+        if (state == make_state(generation, DONE))
+        {
+            request.state.store(make_state(generation + 1, FREE));
+            return true;
+        }
+
+        long temp = futex_wait(request.state, state, deadline);
+        if (temp == -1 && errno == ETIMEDOUT) break;
+        sysexcept(temp == -1 && errno != EAGAIN && errno != EINTR, "futex", errno);
+    }
+
+    // timeout: not started --> reclaimed by acquire(), running --> freed by the handler
+    std::uint32_t state = request.state.load( );
+    for (;;)
+    {
+        if (state == make_state(generation, DONE)) break;
+        const std::uint32_t abandoned = make_state(generation, state == make_state(generation, PENDING) ?
+                ABANDONED : ORPHANED);
+        if (request.state.compare_exchange_weak(state, abandoned)) return false;
+    }
+
+    request.state.store(make_state(generation + 1, FREE));
+    return true;
+}
+
+bool RemoteCall::run_on_thread(pthread_t thread, Function_t function, void *argument, std::int64_t timeout_ns)
+{
+    if (function == nullptr) throw std::invalid_argument("RemoteCall: function must not be nullptr.");
+
+    Request &request = acquire( );
+    request.function = function;
+    request.argument = argument;
+    send(thread, request);
+
+    const struct timespec deadline = make_deadline(timeout_ns);
+    return wait(request, timeout_ns >= 0 ? &deadline : nullptr);
+}
+
+std::size_t RemoteCall::run_on_threads(const std::vector<pthread_t> &threads, Function_t function, void *argument,
+        std::int64_t timeout_ns)
+{
+    if (function == nullptr) throw std::invalid_argument("RemoteCall: function must not be nullptr.");
+
+    // send all requests before waiting: the functions run in parallel
+    std::vector<Request*> sent;
+    sent.reserve(threads.size( ));
+    std::exception_ptr error;
+    for (pthread_t thread : threads)
+    {
+        try
+        {
+            Request &request = acquire( );
+            request.function = function;
+            request.argument = argument;
+            send(thread, request);
+            sent.push_back(&request);
+        }
+        catch (...)
+        {
+            error = std::current_exception( );
+            break;
+        }
+    }
+
+    // always wait for the sent requests (argument is used by them)
+    const struct timespec deadline = make_deadline(timeout_ns);
+    std::size_t finished = 0;
+    for (Request *request : sent)
+        if (wait(*request, timeout_ns >= 0 ? &deadline : nullptr)) ++finished;
+
+    if (error) std::rethrow_exception(error);
+    return finished;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
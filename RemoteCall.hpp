@@ -0,0 +1,186 @@
+/*
+ * \file RemoteCall.hpp
+ * \brief Header file de::Koesling::Signal::RemoteCall
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalHandler.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <pthread.h>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Execute functions on a specific thread
+ *
+ * run_on_thread() sends a reserved realtime signal to the target thread.
+ * The signal carries a pointer to a preallocated request (si_value). The
+ * signal handler of the target thread executes the function and signals
+ * completion (futex). No polling in the target thread is required
+ * (e.g. to flush thread local caches).
+ *
+ * The function runs in signal handler context of the target thread and
+ * must be async-signal-safe. It is not executed while the target thread
+ * blocks the signal.
+ */
+class RemoteCall : private SignalSink
+{
+    public:
+        //! remote function type
+        typedef void (*Function_t)(void*);
+
+    private:
+        /*! \brief request states
+         *
+         * The state word of a request holds the state (low STATE_BITS bits)
+         * and the generation of the slot. The generation is incremented
+         * when a slot is freed or reclaimed and is sent with the signal: a
+         * signal of an earlier request (e.g. delivered after the target
+         * thread unblocked it) is ignored.
+         */
+        enum : std::uint32_t
+        {
+            FREE,      //!< slot is unused
+            PENDING,   //!< signal sent, function not yet started
+            RUNNING,   //!< function is executed
+            DONE,      //!< function finished
+            ABANDONED, //!< caller gave up before the function started (slot can be reclaimed)
+            ORPHANED   //!< caller gave up while the function runs (slot is freed by the handler)
+        };
+
+        //! number of state bits of the state word
+        static constexpr unsigned STATE_BITS = 3;
+        static constexpr std::uint32_t STATE_MASK = (1u << STATE_BITS) - 1;
+
+        //! preallocated request
+        struct Request
+        {
+            //! generation and state (futex word)
+            std::atomic<std::uint32_t> state;
+            //! function
+            Function_t function;
+            //! function argument
+            void *argument;
+        };
+
+        //! build state word
+        static inline std::uint32_t make_state(std::uint32_t generation, std::uint32_t state) noexcept;
+
+        //! reserved realtime signal
+        int signal_number;
+
+        //! request slots
+        std::unique_ptr<Request[]> requests;
+
+        //! number of request slots
+        std::size_t request_count;
+
+        //! installed trampoline
+        SignalHandler signal_handler;
+
+        //! execute request (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+        //! get free request slot (reclaims abandoned slots)
+        Request& acquire( );
+
+        //! send request to thread
+        void send(pthread_t thread, Request &request);
+
+        /*! \brief wait for completion of a request
+         *
+         * deadline: absolute CLOCK_MONOTONIC time (nullptr: no timeout)
+         * returns false (and abandons the request) on timeout
+         */
+        bool wait(Request &request, const struct timespec *deadline);
+
+    public:
+        /*! \brief reserve signal and install handler
+         *
+         * attributes:
+         *   max_pending: maximum number of concurrent requests
+         * possible_throws:
+         *   std::invalid_argument: max_pending is 0
+         *   std::runtime_error   : no free realtime signal
+         *   std::system_error    : a system call failed
+         */
+        explicit RemoteCall(std::size_t max_pending = 64);
+
+        /*! \brief revoke handler and release signal
+         *
+         * No request may be pending. Signals of abandoned requests that are
+         * still queued are discarded (the signal is ignored before the
+         * handler is revoked).
+         */
+        ~RemoteCall( );
+
+        /*! \brief execute function on thread and wait for completion
+         *
+         * If the timeout expires, the request is abandoned: the function is
+         * not started anymore, but may still be running. argument must
+         * therefore stay valid until the function would have finished.
+         * The slot of a request that was not started is reused even if the
+         * target thread exited or blocks the signal.
+         *
+         * attributes:
+         *   thread    : target thread
+         *   function  : async-signal-safe function
+         *   argument  : argument of the function
+         *   timeout_ns: timeout (negative: no timeout)
+         * returns false if the function did not finish within the timeout
+         *
+         * possible_throws:
+         *   std::runtime_error: too many pending requests
+         *   std::system_error : a system call failed (e.g. thread does not exist)
+         */
+        bool run_on_thread(pthread_t thread, Function_t function, void *argument, std::int64_t timeout_ns = -1);
+
+        /*! \brief execute function on several threads in parallel and wait for completion
+         *
+         * returns the number of threads that finished the function within the timeout
+         *
+         * possible_throws:
+         *   std::runtime_error: too many pending requests
+         *   std::system_error : a system call failed (e.g. thread does not exist)
+         */
+        std::size_t run_on_threads(const std::vector<pthread_t> &threads, Function_t function, void *argument,
+                std::int64_t timeout_ns = -1);
+
+        //! get the reserved signal
+        inline int get_signal_number( ) const noexcept;
+
+        //! copying not allowed
+        RemoteCall(const RemoteCall &other) = delete;
+        //! copying not allowed
+        RemoteCall& operator=(const RemoteCall &other) = delete;
+};
+
+inline std::uint32_t RemoteCall::make_state(std::uint32_t generation, std::uint32_t state) noexcept
+{
+    return generation << STATE_BITS | state;
+}
+
+inline int RemoteCall::get_signal_number( ) const noexcept
+{
+    return signal_number;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
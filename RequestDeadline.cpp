@@ -0,0 +1,225 @@
+/*
+ * \file RequestDeadline.cpp
+ * \brief Source file de::Koesling::Signal::RequestDeadline
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *          -rdynamic (symbol names in the default report)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "RequestDeadline.hpp"
+#include "RealtimeSignals.hpp"
+#include "SignalEvent.hpp"
+#include "StackCapture.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <csignal>
+#include <sys/syscall.h>
+#include <sysexits.h>
+#include <unistd.h>
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+constexpr int RequestDeadline::MAX_FRAMES;
+
+//! set one shot timer (0: disarm)
+static int set_timer(timer_t timer, std::chrono::microseconds value) noexcept
+{
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = 0;
+    spec.it_interval.tv_nsec = 0;
+    spec.it_value.tv_sec = static_cast<time_t>(value.count( ) / 1000000);
+    spec.it_value.tv_nsec = static_cast<long>(value.count( ) % 1000000) * 1000;
+    return timer_settime(timer, 0, &spec, nullptr);
+}
+
+RequestDeadline::Registration::Registration(RequestDeadline *deadline, Entry *entry) noexcept :
+        deadline(deadline),
+        entry(entry)
+{ }
+
+RequestDeadline::Registration::Registration(Registration &&other) noexcept :
+        deadline(other.deadline),
+        entry(other.entry)
+{
+    other.deadline = nullptr;
+    other.entry = nullptr;
+}
+
+RequestDeadline::Registration::~Registration( )
+{
+    if (deadline != nullptr) deadline->unregister(entry);
+}
+
+void RequestDeadline::Registration::start(std::uint64_t request_id, std::chrono::microseconds budget)
+{
+    // a budget of 0 would disarm the timer
+    if (budget.count( ) <= 0) budget = std::chrono::microseconds(1);
+
+    entry->request_id = request_id;
+    entry->budget = budget;
+    entry->expired.store(false, std::memory_order_relaxed);
+    entry->start = monotonic_ns( );
+    entry->deadline.store(entry->start + static_cast<std::uint64_t>(budget.count( )) * 1000u,
+            std::memory_order_release);
+
+    int temp = set_timer(entry->timer, budget);
+    sysexcept(temp != 0, "timer_settime", errno);
+}
+
+bool RequestDeadline::Registration::finish( )
+{
+    const std::uint64_t end = monotonic_ns( );
+
+    // a signal that is still pending is ignored by the handler (deadline 0)
+    entry->deadline.store(0, std::memory_order_release);
+    int temp = set_timer(entry->timer, std::chrono::microseconds(0));
+    sysexcept(temp != 0, "timer_settime", errno);
+
+    if (!entry->expired.load(std::memory_order_acquire) || entry->captured_request != entry->request_id) return false;
+
+    SlowRequestReport report;
+    report.request_id = entry->request_id;
+    report.thread = entry->tid;
+    report.budget = entry->budget;
+    report.duration = std::chrono::microseconds((end - entry->start) / 1000u);
+    report.frames.assign(entry->frames, entry->frames + entry->frame_count);
+    deadline->report_function(report);
+    return true;
+}
+
+RequestDeadline::RequestDeadline(ReportFunction_t report_function) :
+        report_function(report_function ? std::move(report_function) : write_report),
+        signal_number(RealtimeSignals::reserve( )),
+        signal_handler(signal_number, SignalTrampoline::handler, SA_RESTART) // requests are not interrupted
+{
+    StackCapture::prime( );
+
+    try
+    {
+        SignalTrampoline::attach(signal_number, this);
+        try
+        {
+            signal_handler.establish( );
+        }
+        catch (...)
+        {
+            SignalTrampoline::detach(signal_number, this);
+            throw;
+        }
+    }
+    catch (...)
+    {
+        RealtimeSignals::release(signal_number);
+        throw;
+    }
+}
+
+RequestDeadline::~RequestDeadline( )
+{
+    try
+    {
+        signal_handler.revoke( );
+    }
+    catch (const std::exception &e) // system call failed
+    {
+        destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+    }
+    SignalTrampoline::detach(signal_number, this);
+    RealtimeSignals::release(signal_number);
+}
+
+RequestDeadline::Registration RequestDeadline::register_thread( )
+{
+    std::lock_guard<std::mutex> lock(entries_mutex);
+
+    // reuse entry of an unregistered thread
+    Entry *entry = nullptr;
+    for (auto &candidate : entries)
+        if (!candidate->active)
+        {
+            entry = candidate.get( );
+            break;
+        }
+
+    if (entry == nullptr)
+    {
+        entries.emplace_back(HugePageArena::create<Entry>( ));
+        entry = entries.back( ).get( );
+    }
+
+    entry->tid = static_cast<pid_t>(syscall(SYS_gettid));
+    entry->request_id = 0;
+    entry->start = 0;
+    entry->budget = std::chrono::microseconds(0);
+    entry->deadline.store(0);
+    entry->expired.store(false);
+    entry->captured_request = 0;
+    entry->frame_count = 0;
+
+    // deliver the expiration to this thread, the entry identifies the timer
+    struct sigevent event;
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = signal_number;
+    event.sigev_value.sival_ptr = entry;
+    event.sigev_notify_thread_id = entry->tid;
+    int temp = timer_create(CLOCK_MONOTONIC, &event, &entry->timer);
+    sysexcept(temp != 0, "timer_create", errno);
+
+    entry->active = true;
+    return Registration(this, entry);
+}
+
+void RequestDeadline::unregister(Entry *entry) noexcept
+{
+    // the entry is kept: a pending expiration may still be delivered
+    std::lock_guard<std::mutex> lock(entries_mutex);
+    entry->deadline.store(0);
+    timer_delete(entry->timer);
+    entry->active = false;
+}
+
+void RequestDeadline::on_signal(int, siginfo_t *info, void*) noexcept
+{
+    // only accept timer expirations
+    if (info->si_code != SI_TIMER) return;
+    Entry *entry = static_cast<Entry*>(info->si_value.sival_ptr);
+
+    // ignore expirations of finished requests
+    const std::uint64_t deadline = entry->deadline.load(std::memory_order_acquire);
+    if (deadline == 0 || monotonic_ns( ) < deadline) return;
+
+    entry->frame_count = StackCapture::capture(entry->frames, MAX_FRAMES);
+    entry->captured_request = entry->request_id;
+    entry->expired.store(true, std::memory_order_release);
+}
+
+void RequestDeadline::write_report(const SlowRequestReport &report)
+{
+    std::ostream &stream = SignalHandler::get_error_stream( );
+    stream << "RequestDeadline: request " << report.request_id << " (thread " << report.thread << ") took "
+            << report.duration.count( ) << " us (budget " << report.budget.count( ) << " us)\n";
+    if (report.frames.empty( ))
+        stream << "  (no stack captured)\n";
+    else
+        StackCapture::write(stream, report.frames.data( ), static_cast<int>(report.frames.size( )));
+    stream.flush( );
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
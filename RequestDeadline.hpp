@@ -0,0 +1,197 @@
+/*
+ * \file RequestDeadline.hpp
+ * \brief Header file de::Koesling::Signal::RequestDeadline
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *          -rdynamic (symbol names in the default report)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "HugePageArena.hpp"
+#include "SignalHandler.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sys/types.h>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! report of a request that exceeded its latency budget
+struct SlowRequestReport
+{
+    //! request id given to start()
+    std::uint64_t request_id;
+    //! kernel thread id
+    pid_t thread;
+    //! latency budget
+    std::chrono::microseconds budget;
+    //! total duration of the request
+    std::chrono::microseconds duration;
+    //! return addresses captured when the budget expired
+    std::vector<void*> frames;
+};
+
+/*! \brief Capture the stack of requests that exceed their latency budget
+ *
+ * Every registered thread owns a posix timer that delivers a reserved
+ * realtime signal to this thread (SIGEV_THREAD_ID). start() arms the timer
+ * with the latency budget of a request, finish() disarms it. If the budget
+ * expires, the handler captures the stack of the thread into a
+ * preallocated buffer tagged with the request id. The request itself is not
+ * interrupted (SA_RESTART). finish() passes a SlowRequestReport to the
+ * report function (in the context of the finishing thread).
+ */
+class RequestDeadline : private SignalSink
+{
+    public:
+        //! maximum number of captured frames
+        static constexpr int MAX_FRAMES = 64;
+
+        //! report function type
+        typedef std::function<void(const SlowRequestReport&)> ReportFunction_t;
+
+    private:
+        //! state of a registered thread (never released before the RequestDeadline object)
+        struct Entry
+        {
+            timer_t timer;
+            pid_t tid;
+            bool active;
+
+            //! current request
+            std::uint64_t request_id;
+            std::uint64_t start;
+            std::chrono::microseconds budget;
+
+            //! absolute deadline (CLOCK_MONOTONIC ns, 0: no request)
+            std::atomic<std::uint64_t> deadline;
+
+            //! capture (written by the signal handler)
+            std::atomic<bool> expired;
+            std::uint64_t captured_request;
+            int frame_count;
+            void *frames[MAX_FRAMES];
+        };
+
+    public:
+        /*! \brief registration of a thread
+         *
+         * The timer is deleted by the destructor.
+         */
+        class Registration
+        {
+            private:
+                RequestDeadline *deadline;
+                Entry *entry;
+
+                friend class RequestDeadline;
+                Registration(RequestDeadline *deadline, Entry *entry) noexcept;
+
+            public:
+                //! unregister thread
+                ~Registration( );
+
+                /*! \brief start request: arm the timer
+                 *
+                 * possible_throws:
+                 *   std::system_error: timer_settime failed
+                 */
+                void start(std::uint64_t request_id, std::chrono::microseconds budget);
+
+                /*! \brief finish request: disarm the timer and report if the budget expired
+                 *
+                 * returns true if the budget expired
+                 *
+                 * possible_throws:
+                 *   std::system_error: timer_settime failed
+                 */
+                bool finish( );
+
+                //! copying not allowed
+                Registration(const Registration &other) = delete;
+                //! copying not allowed
+                Registration& operator=(const Registration &other) = delete;
+
+                //! move this object
+                Registration(Registration &&other) noexcept;
+        };
+
+    private:
+        //! report function
+        ReportFunction_t report_function;
+
+        //! reserved realtime signal
+        int signal_number;
+
+        //! registered threads (in handler memory of HugePageArena)
+        std::vector<std::unique_ptr<Entry, HugePageArena::Deleter>> entries;
+        std::mutex entries_mutex;
+
+        //! capture handler
+        SignalHandler signal_handler;
+
+        //! capture stack (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+        //! unregister entry
+        void unregister(Entry *entry) noexcept;
+
+    public:
+        /*! \brief reserve signal and install handler
+         *
+         * attributes:
+         *   report_function: called by finish() for every slow request
+         *                    (nullptr: write report to SignalHandler error stream)
+         * possible_throws:
+         *   std::runtime_error: no free realtime signal
+         *   std::system_error : a system call failed
+         */
+        explicit RequestDeadline(ReportFunction_t report_function = nullptr);
+
+        //! revoke handler (all registrations must be destroyed before)
+        ~RequestDeadline( );
+
+        /*! \brief register the calling thread (creates its timer)
+         *
+         * possible_throws:
+         *   std::system_error: timer_create failed
+         */
+        Registration register_thread( );
+
+        //! get the reserved signal
+        inline int get_signal_number( ) const noexcept;
+
+        //! default report function (writes to SignalHandler error stream)
+        static void write_report(const SlowRequestReport &report);
+
+        //! copying not allowed
+        RequestDeadline(const RequestDeadline &other) = delete;
+        //! copying not allowed
+        RequestDeadline& operator=(const RequestDeadline &other) = delete;
+};
+
+inline int RequestDeadline::get_signal_number( ) const noexcept
+{
+    return signal_number;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
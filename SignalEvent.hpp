@@ -0,0 +1,130 @@
+/*
+ * \file SignalEvent.hpp
+ * \brief Header file de::Koesling::Signal::SignalEvent
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <sys/signalfd.h>
+#include <sys/types.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief compact representation of a received signal
+ *
+ * Contains the fields of siginfo_t / signalfd_siginfo that are relevant
+ * for deferred signal processing.
+ */
+struct SignalEvent
+{
+    //! signal number
+    int signal;
+    //! signal code (see man sigaction (si_code))
+    int code;
+    //! sending process (or child process for SIGCHLD)
+    pid_t pid;
+    //! real user id of sending process
+    uid_t uid;
+    //! exit value or signal (SIGCHLD only)
+    int status;
+    //! signal value (sigqueue, posix timers)
+    union sigval value;
+    //! receive time (CLOCK_MONOTONIC in nanoseconds)
+    std::uint64_t timestamp;
+};
+
+//! handler function type for deferred signal events
+typedef std::function<void(const SignalEvent&)> SignalEventHandler_t;
+
+/*! \brief read only view of consecutive signal events
+ *
+ * (replacement for std::span, which requires C++20)
+ */
+struct SignalEventSpan
+{
+    //! first event
+    const SignalEvent *data;
+    //! number of events
+    std::size_t size;
+
+    inline const SignalEvent* begin( ) const noexcept
+    {
+        return data;
+    }
+
+    inline const SignalEvent* end( ) const noexcept
+    {
+        return data + size;
+    }
+
+    inline bool empty( ) const noexcept
+    {
+        return size == 0;
+    }
+
+    inline const SignalEvent& operator[](std::size_t index) const noexcept
+    {
+        return data[index];
+    }
+};
+
+/*! \brief get current CLOCK_MONOTONIC time in nanoseconds
+ *
+ * async-signal-safe
+ */
+inline std::uint64_t monotonic_ns( ) noexcept
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<std::uint64_t>(now.tv_sec) * 1000000000u + static_cast<std::uint64_t>(now.tv_nsec);
+}
+
+/*! \brief convert siginfo_t to signal event
+ *
+ * async-signal-safe
+ */
+inline void to_signal_event(const siginfo_t &info, std::uint64_t timestamp, SignalEvent &event) noexcept
+{
+    event.signal = info.si_signo;
+    event.code = info.si_code;
+    event.pid = info.si_pid;
+    event.uid = info.si_uid;
+    event.status = info.si_signo == SIGCHLD ? info.si_status : 0;
+    event.value = info.si_value;
+    event.timestamp = timestamp;
+}
+
+/*! \brief convert signalfd_siginfo to signal event
+ *
+ * async-signal-safe
+ */
+inline void to_signal_event(const signalfd_siginfo &info, std::uint64_t timestamp, SignalEvent &event) noexcept
+{
+    event.signal = static_cast<int>(info.ssi_signo);
+    event.code = info.ssi_code;
+    event.pid = static_cast<pid_t>(info.ssi_pid);
+    event.uid = static_cast<uid_t>(info.ssi_uid);
+    event.status = info.ssi_signo == SIGCHLD ? info.ssi_status : 0;
+    event.value.sival_ptr = reinterpret_cast<void*>(static_cast<std::uintptr_t>(info.ssi_ptr));
+    event.timestamp = timestamp;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,84 @@
+/*
+ * \file SignalEventQueue.cpp
+ * \brief Source file de::Koesling::Signal::SignalEventQueue
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalEventQueue.hpp"
+#include "HugePageArena.hpp"
+#include <new>
+#include <stdexcept>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+SignalEventQueue::SignalEventQueue(std::size_t capacity) :
+        slots(nullptr),
+        mask(slot_count(capacity) - 1),
+        owns_slots(true),
+        write_pos(0),
+        read_pos(0),
+        dropped(0)
+{
+    void *memory = HugePageArena::allocate_handler_memory(sizeof(Slot) * (mask + 1), alignof(Slot));
+    slots = static_cast<Slot*>(memory);
+    for (std::size_t i = 0; i <= mask; ++i)
+        new (&slots[i]) Slot;
+    init_slots( );
+}
+
+SignalEventQueue::SignalEventQueue(std::size_t capacity, HugePageArena &arena) :
+        slots(nullptr),
+        mask(slot_count(capacity) - 1),
+        owns_slots(false),
+        write_pos(0),
+        read_pos(0),
+        dropped(0)
+{
+    void *memory = arena.allocate(sizeof(Slot) * (mask + 1), alignof(Slot));
+    slots = static_cast<Slot*>(memory);
+    for (std::size_t i = 0; i <= mask; ++i)
+        new (&slots[i]) Slot;
+    init_slots( );
+}
+
+SignalEventQueue::~SignalEventQueue( )
+{
+    // arena memory is released with the arena (Slot is trivially destructible)
+    if (owns_slots) HugePageArena::release_handler_memory(slots);
+}
+
+std::size_t SignalEventQueue::slot_count(std::size_t capacity)
+{
+    if (capacity == 0) throw std::invalid_argument("SignalEventQueue: capacity must not be 0.");
+
+    // round up to power of 2
+    std::size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+    return size;
+}
+
+std::size_t SignalEventQueue::memory_size(std::size_t capacity)
+{
+    return sizeof(Slot) * slot_count(capacity);
+}
+
+void SignalEventQueue::init_slots( ) noexcept
+{
+    for (std::size_t i = 0; i <= mask; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
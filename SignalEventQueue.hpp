@@ -0,0 +1,204 @@
+/*
+ * \file SignalEventQueue.hpp
+ * \brief Header file de::Koesling::Signal::SignalEventQueue
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalEvent.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+static_assert(ATOMIC_LONG_LOCK_FREE == 2, "lock free atomics are required.");
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+class HugePageArena;
+
+/*! \brief Bounded lock free multi producer multi consumer queue of signal events
+ *
+ * push() is async-signal-safe and can be used inside signal handlers.
+ * If the queue is full, the event is dropped and counted.
+ *
+ * (bounded MPMC queue by D. Vyukov)
+ */
+class SignalEventQueue
+{
+    private:
+        //! queue slot
+        struct Slot
+        {
+            std::atomic<std::size_t> sequence;
+            SignalEvent event;
+        };
+
+        //! slot buffer
+        Slot *slots;
+
+        //! number of slots - 1 (number of slots is a power of 2)
+        std::size_t mask;
+
+        //! slots are allocated by this object (not by an explicit arena)
+        bool owns_slots;
+
+        //! round capacity up to power of 2
+        static std::size_t slot_count(std::size_t capacity);
+
+        //! init slot sequence numbers
+        void init_slots( ) noexcept;
+
+        //! next write position
+        alignas(64) std::atomic<std::size_t> write_pos;
+
+        //! next read position
+        alignas(64) std::atomic<std::size_t> read_pos;
+
+        //! number of events dropped because the queue was full
+        alignas(64) std::atomic<std::uint64_t> dropped;
+
+    public:
+        /*! \brief create queue
+         *
+         * The slots are taken from the library arena if it exists (see
+         * HugePageArena::allocate_handler_memory()).
+         *
+         * attributes:
+         *   capacity: minimum number of events the queue can hold
+         *             (rounded up to the next power of 2)
+         * possible_throws:
+         *   std::invalid_argument: capacity is 0
+         *   std::bad_alloc       : out of memory
+         */
+        explicit SignalEventQueue(std::size_t capacity = 1024);
+
+        /*! \brief create queue with slots in preallocated memory
+         *
+         * attributes:
+         *   capacity: minimum number of events the queue can hold
+         *             (rounded up to the next power of 2)
+         *   arena   : arena that provides the slots (must outlive the queue)
+         * possible_throws:
+         *   std::invalid_argument: capacity is 0
+         *   std::bad_alloc       : arena exhausted
+         */
+        SignalEventQueue(std::size_t capacity, HugePageArena &arena);
+
+        //! destroy queue
+        ~SignalEventQueue( );
+
+        /*! \brief add event to queue
+         *
+         * async-signal-safe
+         * returns false (and counts the event as dropped) if the queue is full
+         */
+        inline bool push(const SignalEvent &event) noexcept;
+
+        /*! \brief remove event from queue
+         *
+         * returns false if the queue is empty
+         */
+        inline bool pop(SignalEvent &event) noexcept;
+
+        //! get number of dropped events
+        inline std::uint64_t get_dropped( ) const noexcept;
+
+        //! get number of slots
+        inline std::size_t get_capacity( ) const noexcept;
+
+        /*! \brief get number of bytes the slots of a queue with capacity occupy
+         *
+         * possible_throws:
+         *   std::invalid_argument: capacity is 0
+         */
+        static std::size_t memory_size(std::size_t capacity);
+
+        //! copying not allowed
+        SignalEventQueue(const SignalEventQueue &other) = delete;
+        //! copying not allowed
+        SignalEventQueue& operator=(const SignalEventQueue &other) = delete;
+};
+
+inline bool SignalEventQueue::push(const SignalEvent &event) noexcept
+{
+    std::size_t pos = write_pos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot &slot = slots[pos & mask];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+        if (diff == 0)	// slot is free
+        {
+            if (write_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                slot.event = event;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)	// queue full
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else	// other producer was faster
+        {
+            pos = write_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+inline bool SignalEventQueue::pop(SignalEvent &event) noexcept
+{
+    std::size_t pos = read_pos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot &slot = slots[pos & mask];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos + 1);
+
+        if (diff == 0)	// slot contains event
+        {
+            if (read_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                event = slot.event;
+                slot.sequence.store(pos + mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)	// queue empty
+        {
+            return false;
+        }
+        else	// other consumer was faster
+        {
+            pos = read_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+inline std::uint64_t SignalEventQueue::get_dropped( ) const noexcept
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+inline std::size_t SignalEventQueue::get_capacity( ) const noexcept
+{
+    return mask + 1;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,66 @@
+/*
+ * \file SignalFd.cpp
+ * \brief Source file de::Koesling::Signal::SignalFd
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalFd.hpp"
+#include "common_header/sysexcept.hpp"
+#include <cerrno>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+SignalFd::SignalFd(const sigset_t &signals, int flags, bool block_signals) :
+        fd(-1),
+        signal_mask(signals)
+{
+    if (block_signals)
+    {
+        // pthread_sigmask does not use errno
+        int temp = pthread_sigmask(SIG_BLOCK, &signal_mask, nullptr);
+        sysexcept(temp != 0, "pthread_sigmask", temp);
+    }
+
+    fd = signalfd(-1, &signal_mask, flags);
+    sysexcept(fd == -1, "signalfd", errno);
+}
+
+SignalFd::~SignalFd( )
+{
+    if (fd != -1) close(fd);
+}
+
+SignalFd::SignalFd(SignalFd &&other) noexcept :
+        fd(other.fd),
+        signal_mask(other.signal_mask)
+{
+    other.fd = -1;
+}
+
+SignalFd& SignalFd::operator=(SignalFd &&other) noexcept
+{
+    if (this != &other)	// skip self assignment
+    {
+        if (fd != -1) close(fd);
+        fd = other.fd;
+        signal_mask = other.signal_mask;
+        other.fd = -1;
+    }
+    return *this;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
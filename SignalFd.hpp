@@ -0,0 +1,84 @@
+/*
+ * \file SignalFd.hpp
+ * \brief Header file de::Koesling::Signal::SignalFd
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <csignal>
+#include <sys/signalfd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief File descriptor based signal reception (linux signalfd)
+ *
+ * The signals are accepted by reading from the file descriptor instead of
+ * interrupting a thread. Signals that are accepted via a signalfd must be
+ * blocked in every thread of the process.
+ */
+class SignalFd
+{
+    private:
+        //! signalfd file descriptor (-1 if moved)
+        int fd;
+
+        //! signals that are accepted by this file descriptor
+        sigset_t signal_mask;
+
+    public:
+        /*! \brief create signalfd
+         *
+         * attributes:
+         *   signals      : signals which are accepted by the file descriptor
+         *   flags        : see man signalfd (flags)
+         *   block_signals: block the signals in the calling thread.
+         *                  (Threads created afterwards inherit the mask.)
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        explicit SignalFd(const sigset_t &signals, int flags = SFD_NONBLOCK | SFD_CLOEXEC, bool block_signals = true);
+
+        //! close signalfd
+        ~SignalFd( );
+
+        //! get file descriptor
+        inline int get_fd( ) const noexcept;
+
+        //! get signals that are accepted by this file descriptor
+        inline const sigset_t& get_signal_mask( ) const noexcept;
+
+        //! copying not allowed
+        SignalFd(const SignalFd &other) = delete;
+        //! copying not allowed
+        SignalFd& operator=(const SignalFd &other) = delete;
+
+        //! move this object
+        SignalFd(SignalFd &&other) noexcept;
+        //! move this object
+        SignalFd& operator=(SignalFd &&other) noexcept;
+};
+
+inline int SignalFd::get_fd( ) const noexcept
+{
+    return fd;
+}
+
+inline const sigset_t& SignalFd::get_signal_mask( ) const noexcept
+{
+    return signal_mask;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
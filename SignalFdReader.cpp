@@ -0,0 +1,155 @@
+/*
+ * \file SignalFdReader.cpp
+ * \brief Source file de::Koesling::Signal::SignalFdReader
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalFdReader.hpp"
+#include "common_header/sysexcept.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! alignment of the buffers
+static constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// allocate cache line aligned buffer
+static void* aligned_buffer(std::size_t size)
+{
+    void *buffer = nullptr;
+    if (posix_memalign(&buffer, CACHE_LINE_SIZE, size) != 0) throw std::bad_alloc( );
+    return buffer;
+}
+
+SignalFdReader::SignalFdReader(std::size_t capacity, std::size_t max_batches) :
+        capacity(capacity),
+        records(nullptr),
+        events(nullptr),
+        max_batches(max_batches)
+{
+    if (capacity == 0) throw std::invalid_argument("SignalFdReader: capacity must not be 0.");
+    if (max_batches == 0) throw std::invalid_argument("SignalFdReader: max_batches must not be 0.");
+
+    records = static_cast<signalfd_siginfo*>(aligned_buffer(capacity * sizeof(signalfd_siginfo)));
+    try
+    {
+        events = static_cast<SignalEvent*>(aligned_buffer(capacity * max_batches * sizeof(SignalEvent)));
+    }
+    catch (...)
+    {
+        free(records);
+        throw;
+    }
+}
+
+SignalFdReader::~SignalFdReader( )
+{
+    free(records);
+    free(events);
+}
+
+SignalEventSpan SignalFdReader::read(int fd)
+{
+    ssize_t temp = ::read(fd, records, capacity * sizeof(signalfd_siginfo));
+    if (temp == -1)
+    {
+        if (errno == EAGAIN || errno == EINTR) return SignalEventSpan { events, 0 };
+        sysexcept(true, "read", errno);
+    }
+
+    return convert(records, static_cast<std::size_t>(temp) / sizeof(signalfd_siginfo));
+}
+
+SignalEventSpan SignalFdReader::drain(int fd, bool &more_pending)
+{
+    std::size_t count = 0;
+    const std::uint64_t timestamp = monotonic_ns( );
+    more_pending = false;
+
+    for (std::size_t batch = 0; batch < max_batches;)
+    {
+        ssize_t temp = ::read(fd, records, capacity * sizeof(signalfd_siginfo));
+        if (temp == -1)
+        {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) break;
+
+            // keep the records that were already taken from the kernel, report the error next time
+            if (count != 0)
+            {
+                more_pending = true;
+                break;
+            }
+            sysexcept(true, "read", errno);
+        }
+
+        const std::size_t read_count = static_cast<std::size_t>(temp) / sizeof(signalfd_siginfo);
+        for (std::size_t i = 0; i < read_count; ++i)
+            to_signal_event(records[i], timestamp, events[count + i]);
+        count += read_count;
+
+        // short read --> no more pending signals
+        if (read_count < capacity) break;
+
+        // limit reached --> the caller has to drain again
+        if (++batch == max_batches) more_pending = true;
+    }
+
+    return SignalEventSpan { events, count };
+}
+
+SignalEventSpan SignalFdReader::convert(const signalfd_siginfo *raw_records, std::size_t count) noexcept
+{
+    if (count > capacity) count = capacity;
+
+    // one timestamp per batch
+    const std::uint64_t timestamp = monotonic_ns( );
+    for (std::size_t i = 0; i < count; ++i)
+        to_signal_event(raw_records[i], timestamp, events[i]);
+
+    return SignalEventSpan { events, count };
+}
+
+SignalFdReader::SignalFdReader(SignalFdReader &&other) noexcept :
+        capacity(other.capacity),
+        records(other.records),
+        events(other.events),
+        max_batches(other.max_batches)
+{
+    other.records = nullptr;
+    other.events = nullptr;
+}
+
+SignalFdReader& SignalFdReader::operator=(SignalFdReader &&other) noexcept
+{
+    if (this != &other)	// skip self assignment
+    {
+        free(records);
+        free(events);
+        capacity = other.capacity;
+        records = other.records;
+        events = other.events;
+        max_batches = other.max_batches;
+        other.records = nullptr;
+        other.events = nullptr;
+    }
+    return *this;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
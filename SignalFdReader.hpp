@@ -0,0 +1,150 @@
+/*
+ * \file SignalFdReader.hpp
+ * \brief Header file de::Koesling::Signal::SignalFdReader
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalEvent.hpp"
+#include "SignalFd.hpp"
+#include <cstddef>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Batch reader for signalfd file descriptors
+ *
+ * Reads up to capacity records per system call into a reusable, cache line
+ * aligned buffer and converts them to SignalEvent.
+ * No memory is allocated after construction.
+ *
+ * The returned spans stay valid until the next call of read(), drain() or
+ * convert().
+ */
+class SignalFdReader
+{
+    private:
+        //! maximum number of records per read
+        std::size_t capacity;
+
+        //! raw record buffer (cache line aligned)
+        signalfd_siginfo *records;
+
+        //! converted events (cache line aligned)
+        SignalEvent *events;
+
+        //! maximum number of reads per drain()
+        std::size_t max_batches;
+
+    public:
+        /*! \brief create reader
+         *
+         * attributes:
+         *   capacity   : maximum number of records per read
+         *   max_batches: maximum number of reads per drain() (the event
+         *                buffer holds capacity * max_batches events)
+         * possible_throws:
+         *   std::invalid_argument: capacity or max_batches is 0
+         *   std::bad_alloc       : out of memory
+         */
+        explicit SignalFdReader(std::size_t capacity = 64, std::size_t max_batches = 16);
+
+        //! destroy reader
+        ~SignalFdReader( );
+
+        /*! \brief read all available records (up to capacity)
+         *
+         * Performs exactly one read system call.
+         * Returns an empty span if the (non blocking) file descriptor has no
+         * pending signals or the call was interrupted.
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        SignalEventSpan read(int fd);
+
+        //! read all available records (up to capacity) (see read(int))
+        inline SignalEventSpan read(const SignalFd &signal_fd);
+
+        /*! \brief read pending records
+         *
+         * Reads until the file descriptor has no pending signals (a read
+         * returns less than capacity records), but at most max_batches
+         * times. more_pending is set if the limit was reached (signals may
+         * still be pending): call drain() again, e.g. after other work, to
+         * keep a signal storm from starving the caller.
+         * Required if the file descriptor is watched edge triggered (e.g.
+         * multishot poll), where pending records do not cause another
+         * notification.
+         *
+         * The file descriptor must be non blocking (SFD_NONBLOCK): otherwise
+         * the call blocks if the pending records fill the last read exactly.
+         *
+         * If a read fails after records were read, the records read so far
+         * are returned and more_pending is set; the error is reported by the
+         * next call.
+         *
+         * possible_throws:
+         *   std::system_error: the first read failed
+         */
+        SignalEventSpan drain(int fd, bool &more_pending);
+
+        //! read pending records (see drain(int, bool&))
+        inline SignalEventSpan drain(const SignalFd &signal_fd, bool &more_pending);
+
+        /*! \brief convert externally read records
+         *
+         * At most capacity records are converted.
+         */
+        SignalEventSpan convert(const signalfd_siginfo *raw_records, std::size_t count) noexcept;
+
+        //! get maximum number of records per read
+        inline std::size_t get_capacity( ) const noexcept;
+
+        //! get maximum number of reads per drain()
+        inline std::size_t get_max_batches( ) const noexcept;
+
+        //! copying not allowed
+        SignalFdReader(const SignalFdReader &other) = delete;
+        //! copying not allowed
+        SignalFdReader& operator=(const SignalFdReader &other) = delete;
+
+        //! move this object
+        SignalFdReader(SignalFdReader &&other) noexcept;
+        //! move this object
+        SignalFdReader& operator=(SignalFdReader &&other) noexcept;
+};
+
+inline SignalEventSpan SignalFdReader::read(const SignalFd &signal_fd)
+{
+    return read(signal_fd.get_fd( ));
+}
+
+inline SignalEventSpan SignalFdReader::drain(const SignalFd &signal_fd, bool &more_pending)
+{
+    return drain(signal_fd.get_fd( ), more_pending);
+}
+
+inline std::size_t SignalFdReader::get_capacity( ) const noexcept
+{
+    return capacity;
+}
+
+inline std::size_t SignalFdReader::get_max_batches( ) const noexcept
+{
+    return max_batches;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -13,6 +13,10 @@
  */
 
 #include "SignalHandler.hpp"
+#include "DeliveryCounter.hpp"
+#include "HandlerWarmup.hpp"
+#include "HandlerWatchdog.hpp"
+#include "SignalRegistry.hpp"
 #include "common_header/sysexcept.hpp"
 #include "common_header/destructor_exception.hpp"
 #include <cstring>
@@ -30,7 +34,15 @@ std::ostream *SignalHandler::error_stream = &std::cerr;
 SignalHandler::SignalHandler(int signal_number, SignalHandler_t handler_function, int sa_flags,
         sigset_t *blocked_signals) :
         signal_number(signal_number),
-        established(false)
+        established(false),
+        timing_enabled(false),
+        timing_threshold(0),
+        old_timing_threshold(0),
+        counting_enabled(false),
+        warmup_enabled(false),
+        warmup_stack_bytes(0),
+        warmup_dry_run(nullptr),
+        warmup_lock_code(false)
 {
     // initialize sigaction structure with 0
     memset(&curent_signal_action, 0, sizeof(curent_signal_action));
@@ -64,7 +76,15 @@ SignalHandler::SignalHandler(int signal_number, SignalHandler_t handler_function
 SignalHandler::SignalHandler(int signal_number, SignalHandler_extended_t handler_function, int sa_flags,
         sigset_t *blocked_signals) :
         signal_number(signal_number),
-        established(false)
+        established(false),
+        timing_enabled(false),
+        timing_threshold(0),
+        old_timing_threshold(0),
+        counting_enabled(false),
+        warmup_enabled(false),
+        warmup_stack_bytes(0),
+        warmup_dry_run(nullptr),
+        warmup_lock_code(false)
 {
     // initialize sigaction structure with 0
     memset(&curent_signal_action, 0, sizeof(curent_signal_action));
@@ -99,8 +119,21 @@ SignalHandler::SignalHandler(SignalHandler &&other) noexcept :
         signal_number(std::move(other.signal_number)),
         established(std::move(other.established)),
         curent_signal_action(std::move(other.curent_signal_action)),
-        old_signal_action(std::move(other.old_signal_action))
-{ }
+        old_signal_action(std::move(other.old_signal_action)),
+        timing_enabled(other.timing_enabled),
+        timing_threshold(other.timing_threshold),
+        old_timed_action(other.old_timed_action),
+        old_timing_threshold(other.old_timing_threshold),
+        counting_enabled(other.counting_enabled),
+        old_counted_action(other.old_counted_action),
+        warmup_enabled(other.warmup_enabled),
+        warmup_stack_bytes(other.warmup_stack_bytes),
+        warmup_dry_run(other.warmup_dry_run),
+        warmup_lock_code(other.warmup_lock_code)
+{
+    // the moved object must not revoke the handler
+    other.established = false;
+}
 
 SignalHandler& SignalHandler::operator=(SignalHandler &&other) noexcept
 {
@@ -111,6 +144,19 @@ SignalHandler& SignalHandler::operator=(SignalHandler &&other) noexcept
         established = std::move(other.established);
         curent_signal_action = std::move(other.curent_signal_action);
         old_signal_action = std::move(other.old_signal_action);
+        timing_enabled = other.timing_enabled;
+        timing_threshold = other.timing_threshold;
+        old_timed_action = other.old_timed_action;
+        old_timing_threshold = other.old_timing_threshold;
+        counting_enabled = other.counting_enabled;
+        old_counted_action = other.old_counted_action;
+        warmup_enabled = other.warmup_enabled;
+        warmup_stack_bytes = other.warmup_stack_bytes;
+        warmup_dry_run = other.warmup_dry_run;
+        warmup_lock_code = other.warmup_lock_code;
+
+        // the moved object must not revoke the handler
+        other.established = false;
     }
     return *this;
 }
@@ -130,23 +176,124 @@ SignalHandler::~SignalHandler( )
     }
 }
 
+void SignalHandler::enable_timing(std::uint64_t threshold_ns)
+{
+    if (established) throw std::logic_error("Timing must be enabled before the signal handler is established.");
+
+    timing_enabled = true;
+    timing_threshold = threshold_ns;
+}
+
+void SignalHandler::enable_counting( )
+{
+    if (established) throw std::logic_error("Counting must be enabled before the signal handler is established.");
+
+    counting_enabled = true;
+}
+
+void SignalHandler::enable_warmup(std::size_t stack_bytes, void (*dry_run)( ), bool lock_code)
+{
+    if (established) throw std::logic_error("Warm up must be enabled before the signal handler is established.");
+
+    warmup_enabled = true;
+    warmup_stack_bytes = stack_bytes;
+    warmup_dry_run = dry_run;
+    warmup_lock_code = lock_code;
+}
+
+void SignalHandler::warmup( )
+{
+    HandlerWarmup::prefault_stack(warmup_stack_bytes);
+    HandlerWarmup::prefault_altstack( );
+
+    if (warmup_dry_run != nullptr) warmup_dry_run( );
+
+    if (warmup_lock_code)
+    {
+        const void *handler = curent_signal_action.sa_flags & SA_SIGINFO ?
+                reinterpret_cast<const void*>(curent_signal_action.sa_sigaction) :
+                reinterpret_cast<const void*>(curent_signal_action.sa_handler);
+        HandlerWarmup::lock_code(handler);
+
+        // trampolines of this library (may be part of another object)
+        if (timing_enabled) HandlerWarmup::lock_code(reinterpret_cast<const void*>(HandlerWatchdog::handler));
+        if (counting_enabled) HandlerWarmup::lock_code(reinterpret_cast<const void*>(DeliveryCounter::handler));
+    }
+}
+
 void SignalHandler::establish( )
 {
+    if (warmup_enabled && !established) warmup( );
+
+    // the timing trampoline calls the handler function
+    struct sigaction action = curent_signal_action;
+    if (timing_enabled)
+    {
+        action.sa_sigaction = HandlerWatchdog::handler;
+        action.sa_flags |= SA_SIGINFO;
+
+        struct sigaction replaced_action;
+        std::uint64_t replaced_threshold;
+        if (!established)
+            HandlerWatchdog::exchange(signal_number, curent_signal_action, timing_threshold, old_timed_action,
+                    old_timing_threshold);
+        else
+            HandlerWatchdog::exchange(signal_number, curent_signal_action, timing_threshold, replaced_action,
+                    replaced_threshold);
+    }
+
+    // the counting trampoline calls the (timing trampoline or) handler function
+    if (counting_enabled)
+    {
+        DeliveryCounter::prepare(signal_number);
+
+        struct sigaction counted_action = action;
+        action.sa_sigaction = DeliveryCounter::handler;
+        action.sa_flags |= SA_SIGINFO;
+
+        struct sigaction replaced_action;
+        if (!established)
+            DeliveryCounter::exchange(signal_number, counted_action, old_counted_action);
+        else
+            DeliveryCounter::exchange(signal_number, counted_action, replaced_action);
+    }
+
     int temp;
     if (!established)	// initial call of establish()
     {
         // establish signal handler and store previous signal action
-        temp = sigaction(signal_number, &curent_signal_action, &old_signal_action);
+        temp = sigaction(signal_number, &action, &old_signal_action);
     }
     else	// recall of establish()
     {
         // establish signal handler, but do not override the stored
         // "old signal action"
-        temp = sigaction(signal_number, &curent_signal_action, nullptr);
+        temp = sigaction(signal_number, &action, nullptr);
     }
-    
+
+    if (temp != 0 && timing_enabled && !established)
+    {
+        // restore previous timed handler
+        const int error = errno;
+        struct sigaction replaced_action;
+        std::uint64_t replaced_threshold;
+        HandlerWatchdog::exchange(signal_number, old_timed_action, old_timing_threshold, replaced_action,
+                replaced_threshold);
+        errno = error;
+    }
+
+    if (temp != 0 && counting_enabled && !established)
+    {
+        // restore previous counted handler
+        const int error = errno;
+        struct sigaction replaced_action;
+        DeliveryCounter::exchange(signal_number, old_counted_action, replaced_action);
+        errno = error;
+    }
+
     sysexcept(temp != 0, "sigaction", errno);
 
+    if (!established) SignalRegistry::add(signal_number, curent_signal_action.sa_flags);
     established = true;
 }
 
@@ -160,6 +307,23 @@ void SignalHandler::revoke( )
     int temp = sigaction(signal_number, &old_signal_action, nullptr);
     sysexcept(temp != 0, "sigaction", errno);
 
+    if (timing_enabled)
+    {
+        // restore previous timed handler
+        struct sigaction replaced_action;
+        std::uint64_t replaced_threshold;
+        HandlerWatchdog::exchange(signal_number, old_timed_action, old_timing_threshold, replaced_action,
+                replaced_threshold);
+    }
+
+    if (counting_enabled)
+    {
+        // restore previous counted handler
+        struct sigaction replaced_action;
+        DeliveryCounter::exchange(signal_number, old_counted_action, replaced_action);
+    }
+
+    SignalRegistry::remove(signal_number);
     established = false;
 }
 
@@ -15,6 +15,8 @@
 #pragma once
 
 #include <csignal>
+#include <cstddef>
+#include <cstdint>
 #include <ostream>
 
 namespace de {
@@ -49,6 +51,45 @@ class SignalHandler
          */
         struct sigaction old_signal_action;
 
+        //! handler invocation is timed (see enable_timing())
+        bool timing_enabled;
+
+        //! execution time threshold in nanoseconds
+        std::uint64_t timing_threshold;
+
+        /*! \brief Previous timed handler of the signal
+         *
+         * restored by call of revoke() (see HandlerWatchdog::exchange())
+         */
+        struct sigaction old_timed_action;
+
+        //! Previous execution time threshold of the signal
+        std::uint64_t old_timing_threshold;
+
+        //! handler deliveries are counted (see enable_counting())
+        bool counting_enabled;
+
+        /*! \brief Previous counted handler of the signal
+         *
+         * restored by call of revoke() (see DeliveryCounter::exchange())
+         */
+        struct sigaction old_counted_action;
+
+        //! warm up on the first establish() (see enable_warmup())
+        bool warmup_enabled;
+
+        //! number of stack bytes to prefault
+        std::size_t warmup_stack_bytes;
+
+        //! dry run function (nullptr: none)
+        void (*warmup_dry_run)( );
+
+        //! lock code pages of the handler
+        bool warmup_lock_code;
+
+        //! warm up stack, code and symbols of the handler
+        void warmup( );
+
         //! error message stream for "non-throwable" errors
         static std::ostream *error_stream;
 
@@ -86,6 +127,47 @@ class SignalHandler
         //! delete Signal handler object
         ~SignalHandler( );
 
+        /*! \brief measure the execution time of the handler function
+         *
+         * The handler function is invoked by the timing trampoline of
+         * HandlerWatchdog. Invocations that take longer than threshold_ns
+         * are logged (see HandlerWatchdog::read_slow_log()).
+         * Must be called before establish().
+         *
+         * possible_throws:
+         *   std::logic_error: handler is already established
+         */
+        void enable_timing(std::uint64_t threshold_ns);
+
+        /*! \brief count deliveries of the signal
+         *
+         * The handler function is invoked by the counting trampoline of
+         * DeliveryCounter (per cpu counter, see DeliveryCounter::get_count()).
+         * Must be called before establish().
+         *
+         * possible_throws:
+         *   std::logic_error: handler is already established
+         */
+        void enable_counting( );
+
+        /*! \brief warm up the first delivery of the signal
+         *
+         * On the first call of establish(), before the handler is installed:
+         *   - stack_bytes of the calling thread's stack and its alternate
+         *     signal stack (if installed) are prefaulted
+         *   - dry_run is called (a function that runs the handler's code
+         *     paths without side effects, e.g. to resolve lazily bound
+         *     symbols of the dynamic loader)
+         *   - with lock_code, the executable segments that contain the
+         *     handler function (and the trampolines of this library) are
+         *     locked into memory
+         * Must be called before establish().
+         *
+         * possible_throws:
+         *   std::logic_error: handler is already established
+         */
+        void enable_warmup(std::size_t stack_bytes = 65536, void (*dry_run)( ) = nullptr, bool lock_code = false);
+
         /*! \brief arm the signal Handler
          *
          * after calling this function, the specified signal is handled by
@@ -127,9 +209,18 @@ class SignalHandler
         //! move this object
         SignalHandler& operator=(SignalHandler &&other) noexcept;
 
+        //! check if the handler is established
+        inline bool is_established( ) const noexcept;
+
+        //! get signal number
+        inline int get_signal_number( ) const noexcept;
+
         //! Set stream for error output for "non-throwable" errors
         inline static void set_error_stream(std::ostream &stream) noexcept;
 
+        //! Get stream for error output for "non-throwable" errors
+        inline static std::ostream& get_error_stream( ) noexcept;
+
         /*! \brief get version of header file
          *
          * only interesting if used as library.
@@ -143,11 +234,26 @@ class SignalHandler
         static unsigned long get_source_version( ) noexcept;
 };
 
+inline bool SignalHandler::is_established( ) const noexcept
+{
+    return established;
+}
+
+inline int SignalHandler::get_signal_number( ) const noexcept
+{
+    return signal_number;
+}
+
 inline void SignalHandler::set_error_stream(std::ostream &stream) noexcept
 {
     error_stream = &stream;
 }
 
+inline std::ostream& SignalHandler::get_error_stream( ) noexcept
+{
+    return *error_stream;
+}
+
 } /* namespace Signal */
 } /* namespace Koesling */
 } /* namespace de */
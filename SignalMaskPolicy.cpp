@@ -0,0 +1,85 @@
+/*
+ * \file SignalMaskPolicy.cpp
+ * \brief Source file de::Koesling::Signal::SignalMaskPolicy
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalMaskPolicy.hpp"
+#include "RealtimeSignals.hpp"
+#include "SignalRegistry.hpp"
+#include "common_header/sysexcept.hpp"
+#include <mutex>
+#include <pthread.h>
+#include <stdexcept>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! protects SignalMaskPolicy::additional
+static std::mutex additional_mutex;
+
+// zero initialized (static storage) --> empty set
+sigset_t SignalMaskPolicy::additional;
+
+void SignalMaskPolicy::add(int signal_number)
+{
+    if (signal_number < SIGHUP || signal_number >= _NSIG)
+        throw std::invalid_argument("Invalid signal number (out of range).");
+
+    if (SignalRegistry::is_synchronous(signal_number))
+        throw std::invalid_argument("Synchronous fault signals must not be blocked.");
+
+    std::lock_guard<std::mutex> lock(additional_mutex);
+    sigaddset(&additional, signal_number);
+}
+
+sigset_t SignalMaskPolicy::get_mask( ) noexcept
+{
+    sigset_t mask = SignalRegistry::handled_signals( );
+
+    {
+        std::lock_guard<std::mutex> lock(additional_mutex);
+        for (int i = SIGHUP; i < _NSIG; ++i)
+            if (sigismember(&additional, i) == 1) sigaddset(&mask, i);
+    }
+
+    for (int i = SIGHUP; i < _NSIG; ++i)
+        if (SignalRegistry::is_synchronous(i) || RealtimeSignals::is_reserved(i)) sigdelset(&mask, i);
+
+    return mask;
+}
+
+void SignalMaskPolicy::apply( )
+{
+    const sigset_t mask = get_mask( );
+
+    // pthread_sigmask does not use errno
+    int temp = pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+    sysexcept(temp != 0, "pthread_sigmask", temp);
+}
+
+ScopedSignalBlock::ScopedSignalBlock(const sigset_t &signals)
+{
+    // pthread_sigmask does not use errno
+    int temp = pthread_sigmask(SIG_BLOCK, &signals, &old_mask);
+    sysexcept(temp != 0, "pthread_sigmask", temp);
+}
+
+ScopedSignalBlock::~ScopedSignalBlock( )
+{
+    pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
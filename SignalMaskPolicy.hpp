@@ -0,0 +1,113 @@
+/*
+ * \file SignalMaskPolicy.hpp
+ * \brief Header file de::Koesling::Signal::SignalMaskPolicy
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <csignal>
+#include <thread>
+#include <utility>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief signal mask of worker threads
+ *
+ * The policy mask contains all signals handled by established SignalHandler
+ * objects (see SignalRegistry) and the additionally registered signals.
+ * Synchronous fault signals and the realtime signals reserved by this
+ * library (see RealtimeSignals) are never part of the mask: the latter are
+ * sent to specific threads (thread kicks, remote calls, stack captures, ...).
+ *
+ * Threads created by spawn_thread() start with the policy mask blocked.
+ * The mask is set before the thread exists (it is inherited from the
+ * creating thread), so there is no window in which the new thread can
+ * receive a process directed signal.
+ */
+class SignalMaskPolicy
+{
+    private:
+        //! additionally blocked signals (see add())
+        static sigset_t additional;
+
+    public:
+        SignalMaskPolicy( ) = delete;
+
+        /*! \brief block signal in spawned threads (even if it is not handled)
+         *
+         * possible_throws:
+         *   std::invalid_argument: synchronous fault signal or invalid signal number
+         */
+        static void add(int signal_number);
+
+        //! get policy mask
+        static sigset_t get_mask( ) noexcept;
+
+        /*! \brief block the policy mask in the calling thread
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        static void apply( );
+
+        /*! \brief create thread that starts with the policy mask blocked
+         *
+         * arguments are passed to the std::thread constructor
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed / thread creation failed
+         */
+        template<typename Function, typename ... Args>
+        static std::thread spawn_thread(Function &&function, Args &&... args);
+};
+
+/*! \brief block signals in the calling thread while the object exists
+ *
+ * The previous mask is restored by the destructor.
+ */
+class ScopedSignalBlock
+{
+    private:
+        //! mask of the calling thread before construction
+        sigset_t old_mask;
+
+    public:
+        /*! \brief block signals
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        explicit ScopedSignalBlock(const sigset_t &signals);
+
+        //! restore previous mask
+        ~ScopedSignalBlock( );
+
+        //! copying not allowed
+        ScopedSignalBlock(const ScopedSignalBlock &other) = delete;
+        //! copying not allowed
+        ScopedSignalBlock& operator=(const ScopedSignalBlock &other) = delete;
+};
+
+template<typename Function, typename ... Args>
+std::thread SignalMaskPolicy::spawn_thread(Function &&function, Args &&... args)
+{
+    // the new thread inherits the mask of the calling thread
+    ScopedSignalBlock block(get_mask( ));
+    return std::thread(std::forward<Function>(function), std::forward<Args>(args)...);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,274 @@
+/*
+ * \file SignalRecorder.cpp
+ * \brief Source file de::Koesling::Signal::SignalRecorder
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalRecorder.hpp"
+#include "HugePageArena.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <sysexits.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! logical thread index (initial-exec: no allocation on first access in signal handler)
+static thread_local int thread_index __attribute__((tls_model("initial-exec"))) = -1;
+
+//! file format identification
+static constexpr char FILE_MAGIC[8] = { 'S', 'I', 'G', 'R', 'E', 'C', '0', '1' };
+
+SignalRecorder::SignalRecorder(std::size_t capacity) :
+        slots(nullptr),
+        capacity(capacity),
+        count(0),
+        dropped(0),
+        clock(0)
+{
+    for (int i = 0; i < _NSIG; ++i)
+    {
+        forward[i] = nullptr;
+        forward_extended[i] = nullptr;
+    }
+
+    // touched by the signal handler: prefault
+    slots = static_cast<Slot*>(HugePageArena::allocate_handler_memory(capacity * sizeof(Slot), alignof(Slot)));
+    memset(static_cast<void*>(slots), 0, capacity * sizeof(Slot));
+    for (std::size_t i = 0; i < capacity; ++i)
+    {
+        new (&slots[i]) Slot;
+        slots[i].complete.store(false, std::memory_order_relaxed);
+    }
+}
+
+SignalRecorder::~SignalRecorder( )
+{
+    for (auto &handler : handlers)
+    {
+        const int signal_number = handler.get_signal_number( );
+        try
+        {
+            handler.revoke( );
+        }
+        catch (const std::exception &e) // system call failed
+        {
+            destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+        }
+        SignalTrampoline::detach(signal_number, this);
+    }
+
+    // Slot is trivially destructible
+    HugePageArena::release_handler_memory(slots);
+}
+
+void SignalRecorder::install(int signal_number, SignalHandler_t handler_function,
+        SignalHandler_extended_t extended_function, int sa_flags, sigset_t *blocked_signals)
+{
+    if (forward[signal_number] != nullptr || forward_extended[signal_number] != nullptr)
+        throw std::logic_error("Signal is already recorded.");
+
+    // validate arguments before the trampoline is attached
+    SignalHandler handler(signal_number, SignalTrampoline::handler, sa_flags, blocked_signals);
+
+    bool attached = false;
+    try
+    {
+        SignalTrampoline::attach(signal_number, this);
+        attached = true;
+
+        // forward before the first delivery
+        forward[signal_number] = handler_function;
+        forward_extended[signal_number] = extended_function;
+
+        handler.establish( );
+        handlers.push_back(std::move(handler));
+    }
+    catch (...)
+    {
+        // the signal can be recorded by a later call
+        forward[signal_number] = nullptr;
+        forward_extended[signal_number] = nullptr;
+        if (attached) SignalTrampoline::detach(signal_number, this);
+        throw;
+    }
+}
+
+void SignalRecorder::record(int signal_number, SignalHandler_t handler_function, int sa_flags,
+        sigset_t *blocked_signals)
+{
+    if (handler_function == nullptr)
+        throw std::invalid_argument("Unable to establish a signal handler with no handler function.");
+
+    if (sa_flags & SA_SIGINFO)
+        throw std::invalid_argument("Flag SA_SIGINFO, but handler function is of the wrong type.");
+
+    if (signal_number < SIGHUP || signal_number >= _NSIG)
+        throw std::invalid_argument("Invalid signal number (out of range).");
+
+    install(signal_number, handler_function, nullptr, sa_flags, blocked_signals);
+}
+
+void SignalRecorder::record(int signal_number, SignalHandler_extended_t handler_function, int sa_flags,
+        sigset_t *blocked_signals)
+{
+    if (handler_function == nullptr)
+        throw std::invalid_argument("Unable to establish a signal handler with no handler function.");
+
+    if (signal_number < SIGHUP || signal_number >= _NSIG)
+        throw std::invalid_argument("Invalid signal number (out of range).");
+
+    install(signal_number, nullptr, handler_function, sa_flags, blocked_signals);
+}
+
+void SignalRecorder::on_signal(int signal_number, siginfo_t *info, void *context) noexcept
+{
+    const std::size_t index = count.fetch_add(1);
+    if (index < capacity)
+    {
+        SignalRecord &record = slots[index].record;
+        record.logical_time = clock.load( );
+        record.thread_index = thread_index;
+        memcpy(&record.info, info, sizeof(record.info));
+        slots[index].complete.store(true, std::memory_order_release);
+    }
+    else
+    {
+        dropped.fetch_add(1);
+    }
+
+    if (forward_extended[signal_number] != nullptr)
+        forward_extended[signal_number](signal_number, info, context);
+    else if (forward[signal_number] != nullptr) forward[signal_number](signal_number);
+}
+
+std::vector<SignalRecord> SignalRecorder::get_records( ) const
+{
+    const std::size_t size = std::min(count.load( ), capacity);
+
+    std::vector<SignalRecord> result;
+    result.reserve(size);
+    for (std::size_t i = 0; i < size; ++i)
+        if (slots[i].complete.load(std::memory_order_acquire)) result.push_back(slots[i].record);
+    return result;
+}
+
+void SignalRecorder::set_thread_index(int index) noexcept
+{
+    thread_index = index;
+}
+
+void SignalRecorder::save(std::ostream &stream) const
+{
+    const std::vector<SignalRecord> data = get_records( );
+    const std::uint64_t size = data.size( );
+
+    stream.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    stream.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    stream.write(reinterpret_cast<const char*>(data.data( )),
+            static_cast<std::streamsize>(data.size( ) * sizeof(SignalRecord)));
+
+    if (!stream) throw std::runtime_error("SignalRecorder: failed to write records.");
+}
+
+std::vector<SignalRecord> SignalRecorder::load(std::istream &stream)
+{
+    char magic[sizeof(FILE_MAGIC)];
+    std::uint64_t size = 0;
+
+    stream.read(magic, sizeof(magic));
+    stream.read(reinterpret_cast<char*>(&size), sizeof(size));
+    if (!stream || memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+        throw std::runtime_error("SignalRecorder: invalid record file.");
+
+    std::vector<SignalRecord> data(size);
+    stream.read(reinterpret_cast<char*>(data.data( )), static_cast<std::streamsize>(size * sizeof(SignalRecord)));
+    if (!stream) throw std::runtime_error("SignalRecorder: failed to read records.");
+
+    return data;
+}
+
+SignalReplayer::SignalReplayer(std::vector<SignalRecord> records) :
+        records(std::move(records)),
+        next(0),
+        clock(0)
+{
+    std::stable_sort(this->records.begin( ), this->records.end( ),
+            [](const SignalRecord &a, const SignalRecord &b) { return a.logical_time < b.logical_time; });
+}
+
+void SignalReplayer::register_thread(int index, pthread_t thread)
+{
+    if (index < 0) throw std::invalid_argument("SignalReplayer: thread index must not be negative.");
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const std::size_t i = static_cast<std::size_t>(index);
+    if (threads.size( ) <= i)
+    {
+        threads.resize(i + 1);
+        thread_registered.resize(i + 1, false);
+    }
+    threads[i] = thread;
+    thread_registered[i] = true;
+}
+
+void SignalReplayer::inject( )
+{
+    while (next < records.size( ) && records[next].logical_time <= clock)
+    {
+        const SignalRecord &record = records[next++];
+        const std::size_t index = static_cast<std::size_t>(record.thread_index);
+
+        if (record.thread_index >= 0 && index < threads.size( ) && thread_registered[index])
+        {
+            // pthread_sigqueue does not use errno
+            int temp = pthread_sigqueue(threads[index], record.info.si_signo, record.info.si_value);
+            sysexcept(temp != 0, "pthread_sigqueue", temp);
+        }
+        else
+        {
+            int temp = sigqueue(getpid( ), record.info.si_signo, record.info.si_value);
+            sysexcept(temp != 0, "sigqueue", errno);
+        }
+    }
+}
+
+void SignalReplayer::start( )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    inject( );
+}
+
+std::uint64_t SignalReplayer::advance( )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    ++clock;
+    inject( );
+    return clock;
+}
+
+bool SignalReplayer::is_done( )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return next == records.size( );
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,251 @@
+/*
+ * \file SignalRecorder.hpp
+ * \brief Header file de::Koesling::Signal::SignalRecorder
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalHandler.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <pthread.h>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! recorded signal delivery
+struct SignalRecord
+{
+    //! logical time of the delivery (see SignalRecorder::advance())
+    std::uint64_t logical_time;
+    //! logical index of the receiving thread (-1: unregistered thread)
+    int thread_index;
+    //! signal information
+    siginfo_t info;
+};
+
+/*! \brief Record signal deliveries relative to application events
+ *
+ * The application advances a logical clock at well defined points (e.g.
+ * "request accepted", "reload started"). Every delivered signal is
+ * recorded with the current logical time and the logical index of the
+ * receiving thread, then the original handler is called.
+ *
+ * Records are stored in a preallocated buffer (async-signal-safe, taken
+ * from the library arena if it exists, see HugePageArena).
+ * Deliveries that exceed the capacity are counted as dropped.
+ * get_records() and save() should be called after recording stopped.
+ */
+class SignalRecorder : private SignalSink
+{
+    private:
+        //! record slot
+        struct Slot
+        {
+            //! record is completely written (set by the signal handler)
+            std::atomic<bool> complete;
+            SignalRecord record;
+        };
+
+        //! preallocated record slots
+        Slot *slots;
+
+        //! number of preallocated record slots
+        std::size_t capacity;
+
+        //! number of used records
+        std::atomic<std::size_t> count;
+
+        //! number of dropped records
+        std::atomic<std::uint64_t> dropped;
+
+        //! logical clock
+        std::atomic<std::uint64_t> clock;
+
+        //! forwarded handlers (no SA_SIGINFO)
+        SignalHandler_t forward[_NSIG];
+
+        //! forwarded handlers (SA_SIGINFO)
+        SignalHandler_extended_t forward_extended[_NSIG];
+
+        //! installed trampolines
+        std::vector<SignalHandler> handlers;
+
+        //! record and forward (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+        //! install trampoline that forwards to handler_function / extended_function
+        void install(int signal_number, SignalHandler_t handler_function, SignalHandler_extended_t extended_function,
+                int sa_flags, sigset_t *blocked_signals);
+
+    public:
+        /*! \brief create recorder
+         *
+         * attributes:
+         *   capacity: maximum number of records
+         * possible_throws:
+         *   std::bad_alloc: out of memory
+         */
+        explicit SignalRecorder(std::size_t capacity = 4096);
+
+        //! revoke all handlers installed by this recorder
+        ~SignalRecorder( );
+
+        /*! \brief record signal and forward it to handler_function
+         *
+         * The arguments are the same as for SignalHandler. The handler is
+         * established immediately.
+         *
+         * possible_throws:
+         *   std::invalid_argument: invalid argument
+         *   std::logic_error     : signal already recorded / handled by another sink
+         *   std::system_error    : a system call failed
+         */
+        void record(int signal_number, SignalHandler_t handler_function, int sa_flags = 0,
+                sigset_t *blocked_signals = nullptr);
+
+        //! record signal and forward it to handler_function (SA_SIGINFO) (see above)
+        void record(int signal_number, SignalHandler_extended_t handler_function, int sa_flags = 0,
+                sigset_t *blocked_signals = nullptr);
+
+        /*! \brief advance logical clock (application event point)
+         *
+         * returns the new logical time
+         */
+        inline std::uint64_t advance( ) noexcept;
+
+        //! get current logical time
+        inline std::uint64_t get_time( ) const noexcept;
+
+        /*! \brief get recorded deliveries
+         *
+         * Records that are still being written by a signal handler are skipped.
+         */
+        std::vector<SignalRecord> get_records( ) const;
+
+        //! get number of deliveries that were not recorded (capacity exceeded)
+        inline std::uint64_t get_dropped( ) const noexcept;
+
+        /*! \brief set logical index of the calling thread
+         *
+         * Use the same index for the corresponding thread in the replay run.
+         */
+        static void set_thread_index(int index) noexcept;
+
+        /*! \brief write records to stream (binary)
+         *
+         * possible_throws:
+         *   std::runtime_error: write failed
+         */
+        void save(std::ostream &stream) const;
+
+        /*! \brief read records written by save()
+         *
+         * possible_throws:
+         *   std::runtime_error: read failed / invalid format
+         */
+        static std::vector<SignalRecord> load(std::istream &stream);
+
+        //! copying not allowed
+        SignalRecorder(const SignalRecorder &other) = delete;
+        //! copying not allowed
+        SignalRecorder& operator=(const SignalRecorder &other) = delete;
+};
+
+/*! \brief Replay recorded signal deliveries
+ *
+ * The application calls advance() at the same points as in the recording
+ * run. All signals recorded for the new logical time are re-injected:
+ * via pthread_sigqueue if the receiving thread was registered with the
+ * recorded thread index, via sigqueue (process directed) otherwise.
+ *
+ * The signal value (si_value) is preserved. Fields that identify the
+ * sender (si_pid, si_uid, si_code) describe the replaying process.
+ */
+class SignalReplayer
+{
+    private:
+        //! records (sorted by logical time)
+        std::vector<SignalRecord> records;
+
+        //! next record to inject
+        std::size_t next;
+
+        //! logical clock
+        std::uint64_t clock;
+
+        //! registered threads (by logical index)
+        std::vector<pthread_t> threads;
+        std::vector<bool> thread_registered;
+
+        //! protects all members
+        std::mutex mutex;
+
+        //! inject all records of the current logical time
+        void inject( );
+
+    public:
+        /*! \brief create replayer
+         *
+         * Records of logical time 0 are injected by start().
+         */
+        explicit SignalReplayer(std::vector<SignalRecord> records);
+
+        //! register thread with logical index (see SignalRecorder::set_thread_index)
+        void register_thread(int index, pthread_t thread);
+
+        /*! \brief inject records of logical time 0
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        void start( );
+
+        /*! \brief advance logical clock and inject the records of the new time
+         *
+         * returns the new logical time
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        std::uint64_t advance( );
+
+        //! check if all records are injected
+        bool is_done( );
+};
+
+inline std::uint64_t SignalRecorder::advance( ) noexcept
+{
+    return clock.fetch_add(1) + 1;
+}
+
+inline std::uint64_t SignalRecorder::get_time( ) const noexcept
+{
+    return clock.load( );
+}
+
+inline std::uint64_t SignalRecorder::get_dropped( ) const noexcept
+{
+    return dropped.load( );
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,79 @@
+/*
+ * \file SignalRegistry.cpp
+ * \brief Source file de::Koesling::Signal::SignalRegistry
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalRegistry.hpp"
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+std::atomic<unsigned> SignalRegistry::handlers[_NSIG];
+std::atomic<int> SignalRegistry::flags[_NSIG];
+
+void SignalRegistry::add(int signal_number, int sa_flags) noexcept
+{
+    if (signal_number < SIGHUP || signal_number >= _NSIG) return;
+    flags[signal_number].store(sa_flags);
+    handlers[signal_number].fetch_add(1);
+}
+
+void SignalRegistry::remove(int signal_number) noexcept
+{
+    if (signal_number < SIGHUP || signal_number >= _NSIG) return;
+
+    unsigned count = handlers[signal_number].load( );
+    while (count != 0 && !handlers[signal_number].compare_exchange_weak(count, count - 1))
+        ;
+}
+
+bool SignalRegistry::is_handled(int signal_number) noexcept
+{
+    if (signal_number < SIGHUP || signal_number >= _NSIG) return false;
+    return handlers[signal_number].load( ) != 0;
+}
+
+int SignalRegistry::get_flags(int signal_number) noexcept
+{
+    if (!is_handled(signal_number)) return 0;
+    return flags[signal_number].load( );
+}
+
+sigset_t SignalRegistry::handled_signals( ) noexcept
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    for (int i = SIGHUP; i < _NSIG; ++i)
+        if (handlers[i].load( ) != 0) sigaddset(&signals, i);
+    return signals;
+}
+
+bool SignalRegistry::is_synchronous(int signal_number) noexcept
+{
+    switch (signal_number)
+    {
+        case SIGSEGV:
+        case SIGBUS:
+        case SIGFPE:
+        case SIGILL:
+        case SIGTRAP:
+        case SIGSYS:
+            return true;
+        default:
+            return false;
+    }
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,67 @@
+/*
+ * \file SignalRegistry.hpp
+ * \brief Header file de::Koesling::Signal::SignalRegistry
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <csignal>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief registry of the signals handled by established SignalHandler objects
+ *
+ * SignalHandler::establish() registers the signal and its sa_flags,
+ * SignalHandler::revoke() unregisters it.
+ */
+class SignalRegistry
+{
+    private:
+        //! number of established handlers per signal
+        static std::atomic<unsigned> handlers[_NSIG];
+
+        //! sa_flags of the most recently established handler per signal
+        static std::atomic<int> flags[_NSIG];
+
+    public:
+        SignalRegistry( ) = delete;
+
+        //! register established handler (called by SignalHandler)
+        static void add(int signal_number, int sa_flags) noexcept;
+
+        //! unregister revoked handler (called by SignalHandler)
+        static void remove(int signal_number) noexcept;
+
+        //! check if an established SignalHandler handles the signal
+        static bool is_handled(int signal_number) noexcept;
+
+        //! get sa_flags of the established handler (0 if not handled)
+        static int get_flags(int signal_number) noexcept;
+
+        //! get all signals handled by established SignalHandler objects
+        static sigset_t handled_signals( ) noexcept;
+
+        /*! \brief check if a signal is a synchronous fault signal
+         *
+         * (SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGTRAP, SIGSYS)
+         * Blocking these signals results in undefined behavior if the
+         * fault occurs.
+         */
+        static bool is_synchronous(int signal_number) noexcept;
+};
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,394 @@
+/*
+ * \file SignalStorm.cpp
+ * \brief Source file de::Koesling::Signal::SignalStorm
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalStorm.hpp"
+#include "common_header/sysexcept.hpp"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*
+ * signal value layout (64 bit):
+ *   bits 56..63: sender id
+ *   bits 32..55: sequence number
+ *   bits  0..31: unused
+ * The send time (CLOCK_MONOTONIC nanoseconds) is stored in send_times
+ * (shared memory, indexed like received): no wrap around of a truncated
+ * timestamp.
+ */
+static constexpr std::size_t MAX_SENDERS = 256;
+static constexpr std::uint32_t MAX_SEQUENCE = 1u << 24;
+
+//! per sender statistics (shared with forked senders)
+struct SenderStats
+{
+    std::atomic<std::uint64_t> sent;
+    std::atomic<std::uint64_t> retries;
+};
+
+static inline union sigval encode(std::size_t sender, std::uint32_t sequence) noexcept
+{
+    const std::uint64_t value = (static_cast<std::uint64_t>(sender) << 56)
+            | (static_cast<std::uint64_t>(sequence) << 32);
+    union sigval result;
+    result.sival_ptr = reinterpret_cast<void*>(static_cast<std::uintptr_t>(value));
+    return result;
+}
+
+static inline bool is_realtime(int signal_number) noexcept
+{
+    return signal_number >= SIGRTMIN && signal_number <= SIGRTMAX;
+}
+
+// send all signals of one sender (async-signal-safe: used after fork)
+static void send_signals(const SignalStormConfig &config, pid_t target, std::size_t sender,
+        SenderStats &stats, std::atomic<std::uint64_t> *send_times) noexcept
+{
+    const std::uint64_t interval = config.rate != 0 ? 1000000000u / config.rate : 0;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    for (std::uint32_t i = 0; i < config.signals_per_sender; ++i)
+    {
+        const int signal_number = config.signals[i % config.signals.size( )];
+
+        for (;;)
+        {
+            send_times[i].store(monotonic_ns( ), std::memory_order_release);
+            if (sigqueue(target, signal_number, encode(sender, i)) == 0) break;
+            if (errno != EAGAIN) return;	// target gone
+            stats.retries.fetch_add(1, std::memory_order_relaxed);
+            sched_yield( );
+        }
+        stats.sent.fetch_add(1, std::memory_order_relaxed);
+
+        if (interval != 0)
+        {
+            next.tv_nsec += static_cast<long>(interval);
+            while (next.tv_nsec >= 1000000000)
+            {
+                next.tv_nsec -= 1000000000;
+                ++next.tv_sec;
+            }
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr) == EINTR)
+                ;
+        }
+    }
+}
+
+// read one block from pipe (returns false at end of file or on error)
+static bool read_block(int fd, void *block, std::size_t size, std::atomic<std::uint64_t> &interrupted,
+        std::atomic<std::uint64_t> &errors)
+{
+    std::size_t done = 0;
+    while (done < size)
+    {
+        ssize_t temp = read(fd, static_cast<char*>(block) + done, size - done);
+        if (temp == -1 && errno == EINTR)
+        {
+            interrupted.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (temp == 0 && done == 0) return false;	// writer finished
+        if (temp <= 0)
+        {
+            errors.fetch_add(1);
+            return false;
+        }
+        done += static_cast<std::size_t>(temp);
+    }
+    return true;
+}
+
+// write one block to pipe (returns false on error)
+static bool write_block(int fd, const void *block, std::size_t size, std::atomic<std::uint64_t> &interrupted,
+        std::atomic<std::uint64_t> &errors)
+{
+    std::size_t done = 0;
+    while (done < size)
+    {
+        ssize_t temp = write(fd, static_cast<const char*>(block) + done, size - done);
+        if (temp == -1 && errno == EINTR)
+        {
+            interrupted.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (temp <= 0)
+        {
+            errors.fetch_add(1);
+            return false;
+        }
+        done += static_cast<std::size_t>(temp);
+    }
+    return true;
+}
+
+// blocking pipe I/O with data verification
+static void io_load(const std::atomic<bool> &stop, std::atomic<std::uint64_t> &interrupted,
+        std::atomic<std::uint64_t> &errors)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        errors.fetch_add(1);
+        return;
+    }
+
+    std::thread writer([&]( ) {
+        std::uint64_t block[8];
+        for (std::uint64_t counter = 0; !stop.load(std::memory_order_relaxed); ++counter)
+        {
+            for (auto &word : block)
+                word = counter;
+            if (!write_block(fds[1], block, sizeof(block), interrupted, errors)) break;
+        }
+        close(fds[1]);	// reader: end of file (also after an error)
+    });
+
+    std::uint64_t block[8];
+    for (std::uint64_t counter = 0; read_block(fds[0], block, sizeof(block), interrupted, errors); ++counter)
+    {
+        for (auto word : block)
+        {
+            if (word != counter)
+            {
+                errors.fetch_add(1);
+                break;
+            }
+        }
+    }
+
+    // after a read error: keep draining, the writer must not block on a full pipe
+    char buffer[512];
+    for (;;)
+    {
+        ssize_t temp = read(fds[0], buffer, sizeof(buffer));
+        if (temp == 0 || (temp == -1 && errno != EINTR)) break;
+    }
+
+    writer.join( );
+    close(fds[0]);
+}
+
+SignalStorm::SignalStorm(const SignalStormConfig &config) :
+        config(config),
+        received_size(0),
+        send_times(nullptr),
+        standard_received(0),
+        realtime_duplicates(0),
+        realtime_deliveries(0)
+{
+    if (config.signals.empty( )) throw std::invalid_argument("SignalStorm: no signals specified.");
+
+    for (int signal_number : config.signals)
+        if (signal_number < SIGHUP || signal_number > SIGRTMAX || signal_number == SIGKILL
+                || signal_number == SIGSTOP)
+            throw std::invalid_argument("SignalStorm: invalid signal number.");
+
+    const std::size_t senders = config.sender_threads + config.sender_processes;
+    if (senders == 0 || senders > MAX_SENDERS)
+        throw std::invalid_argument("SignalStorm: number of senders must be in the range 1..256.");
+
+    if (config.signals_per_sender >= MAX_SEQUENCE)
+        throw std::invalid_argument("SignalStorm: too many signals per sender.");
+
+    received_size = senders * config.signals_per_sender;
+    received.reset(new std::atomic<std::uint8_t>[received_size]);
+    for (std::size_t i = 0; i < received_size; ++i)
+        received[i].store(0, std::memory_order_relaxed);
+
+    // shared memory: also written by forked senders (zero filled)
+    void *memory = mmap(nullptr, received_size * sizeof(std::atomic<std::uint64_t>), PROT_READ | PROT_WRITE,
+            MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    sysexcept(memory == MAP_FAILED, "mmap", errno);
+    send_times = static_cast<std::atomic<std::uint64_t>*>(memory);
+    for (std::size_t i = 0; i < received_size; ++i)
+        new (&send_times[i]) std::atomic<std::uint64_t>(0);
+
+    for (auto &bucket : latency)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+SignalStorm::~SignalStorm( )
+{
+    munmap(send_times, received_size * sizeof(std::atomic<std::uint64_t>));
+}
+
+void SignalStorm::record(int signal_number, const union sigval &value) noexcept
+{
+    const std::uint64_t raw = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(value.sival_ptr));
+    const std::size_t sender = static_cast<std::size_t>(raw >> 56);
+    const std::uint32_t sequence = static_cast<std::uint32_t>((raw >> 32) & (MAX_SEQUENCE - 1));
+    const std::size_t index = sender * config.signals_per_sender + sequence;
+
+    if (index < received_size)
+    {
+        const std::uint64_t delay = monotonic_ns( ) - send_times[index].load(std::memory_order_acquire);
+        unsigned bucket = delay == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(delay));
+        if (bucket > 63) bucket = 63;
+        latency[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (is_realtime(signal_number))
+    {
+        if (index < received_size && received[index].exchange(1, std::memory_order_relaxed) != 0)
+            realtime_duplicates.fetch_add(1, std::memory_order_relaxed);
+        realtime_deliveries.fetch_add(1, std::memory_order_release);
+    }
+    else
+    {
+        standard_received.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SignalStormResult SignalStorm::run(unsigned timeout_ms)
+{
+    const pid_t target = config.target != 0 ? config.target : getpid( );
+    const std::size_t senders = config.sender_threads + config.sender_processes;
+
+    // statistics in shared memory: also written by forked senders
+    void *memory = mmap(nullptr, senders * sizeof(SenderStats), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+            -1, 0);
+    sysexcept(memory == MAP_FAILED, "mmap", errno);
+    SenderStats *stats = static_cast<SenderStats*>(memory);
+    for (std::size_t i = 0; i < senders; ++i)
+    {
+        new (&stats[i].sent) std::atomic<std::uint64_t>(0);
+        new (&stats[i].retries) std::atomic<std::uint64_t>(0);
+    }
+
+    std::atomic<bool> stop_io(false);
+    std::atomic<std::uint64_t> io_interrupted(0);
+    std::atomic<std::uint64_t> io_errors(0);
+    std::vector<std::thread> io;
+    for (std::size_t i = 0; i < config.io_threads; ++i)
+        io.emplace_back(io_load, std::cref(stop_io), std::ref(io_interrupted), std::ref(io_errors));
+
+    const std::uint64_t start = monotonic_ns( );
+
+    std::vector<pid_t> children;
+    for (std::size_t i = 0; i < config.sender_processes; ++i)
+    {
+        pid_t pid = fork( );
+        if (pid == 0)
+        {
+            const std::size_t sender = config.sender_threads + i;
+            send_signals(config, target, sender, stats[sender], send_times + sender * config.signals_per_sender);
+            _exit(0);
+        }
+        if (pid > 0) children.push_back(pid);
+    }
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < config.sender_threads; ++i)
+        threads.emplace_back([this, target, i, stats]( ) {
+            send_signals(config, target, i, stats[i], send_times + i * config.signals_per_sender);
+        });
+
+    for (auto &thread : threads)
+        thread.join( );
+    for (pid_t child : children)
+        while (waitpid(child, nullptr, 0) == -1 && errno == EINTR)
+            ;
+
+    // wait for outstanding realtime signals
+    std::uint64_t realtime_sent = 0;
+    for (std::size_t sender = 0; sender < senders; ++sender)
+        for (std::uint64_t i = 0; i < stats[sender].sent.load( ); ++i)
+            if (is_realtime(config.signals[i % config.signals.size( )])) ++realtime_sent;
+
+    const std::uint64_t deadline = monotonic_ns( ) + static_cast<std::uint64_t>(timeout_ms) * 1000000u;
+    while (realtime_deliveries.load(std::memory_order_acquire) - realtime_duplicates.load( ) < realtime_sent
+            && monotonic_ns( ) < deadline)
+        usleep(100);
+
+    const std::uint64_t end = monotonic_ns( );
+
+    stop_io.store(true);
+    for (auto &thread : io)
+        thread.join( );
+
+    SignalStormResult result;
+    memset(&result, 0, sizeof(result));
+    for (std::size_t i = 0; i < senders; ++i)
+    {
+        result.sent += stats[i].sent.load( );
+        result.send_retries += stats[i].retries.load( );
+    }
+    munmap(memory, senders * sizeof(SenderStats));
+
+    result.realtime_sent = realtime_sent;
+    for (std::size_t i = 0; i < received_size; ++i)
+        result.realtime_received += received[i].load( );
+    result.realtime_duplicates = realtime_duplicates.load( );
+    result.standard_received = standard_received.load( );
+    result.duration = end - start;
+    result.io_interrupted = io_interrupted.load( );
+    result.io_errors = io_errors.load( );
+
+    // percentiles from histogram
+    std::uint64_t total = 0;
+    for (auto &bucket : latency)
+        total += bucket.load( );
+
+    std::uint64_t sum = 0;
+    for (unsigned i = 0; i < 64 && total != 0; ++i)
+    {
+        const std::uint64_t count = latency[i].load( );
+        if (count == 0) continue;
+        const std::uint64_t bound = i == 0 ? 0 : (static_cast<std::uint64_t>(1) << i);
+        sum += count;
+        if (result.latency_p50 == 0 && sum * 2 >= total) result.latency_p50 = bound;
+        if (result.latency_p99 == 0 && sum * 100 >= total * 99) result.latency_p99 = bound;
+        if (result.latency_p999 == 0 && sum * 1000 >= total * 999) result.latency_p999 = bound;
+        result.latency_max = bound;
+    }
+
+    return result;
+}
+
+double SignalStormResult::get_throughput( ) const noexcept
+{
+    if (duration == 0) return 0.0;
+    return static_cast<double>(realtime_received + standard_received) * 1e9 / static_cast<double>(duration);
+}
+
+std::ostream& operator<<(std::ostream &stream, const SignalStormResult &result)
+{
+    stream << "sent:                " << result.sent << " (" << result.send_retries << " retries)\n"
+            << "realtime received:   " << result.realtime_received << " / " << result.realtime_sent << " (lost: "
+            << result.get_realtime_lost( ) << ", duplicates: " << result.realtime_duplicates << ")\n"
+            << "standard received:   " << result.standard_received << '\n'
+            << "duration:            " << result.duration / 1000 << " us\n"
+            << "throughput:          " << result.get_throughput( ) << " signals/s\n"
+            << "latency (<= ns):     p50 " << result.latency_p50 << ", p99 " << result.latency_p99 << ", p99.9 "
+            << result.latency_p999 << ", max " << result.latency_max << '\n'
+            << "I/O:                 " << result.io_interrupted << " interrupted, " << result.io_errors
+            << " errors\n";
+    return stream;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
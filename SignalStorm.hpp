@@ -0,0 +1,184 @@
+/*
+ * \file SignalStorm.hpp
+ * \brief Header file de::Koesling::Signal::SignalStorm
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalEvent.hpp"
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <sys/types.h>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! configuration of a signal storm
+struct SignalStormConfig
+{
+    //! signals that are sent (round robin, standard and realtime signals can be mixed)
+    std::vector<int> signals;
+    //! number of sender threads
+    std::size_t sender_threads = 4;
+    //! number of sender processes (forked)
+    std::size_t sender_processes = 0;
+    //! signals sent per sender
+    std::uint32_t signals_per_sender = 10000;
+    //! send rate per sender in signals per second (0: unlimited)
+    std::uint32_t rate = 0;
+    //! number of threads that perform blocking pipe I/O during the storm
+    std::size_t io_threads = 1;
+    //! target process (0: calling process)
+    pid_t target = 0;
+};
+
+//! result of a signal storm
+struct SignalStormResult
+{
+    //! signals sent (successful sigqueue calls)
+    std::uint64_t sent;
+    //! sigqueue calls that failed with EAGAIN (realtime queue full) and were retried
+    std::uint64_t send_retries;
+    //! realtime signals sent
+    std::uint64_t realtime_sent;
+    //! distinct realtime signals received
+    std::uint64_t realtime_received;
+    //! realtime signals received more than once
+    std::uint64_t realtime_duplicates;
+    //! standard signals received (merged by the kernel while pending)
+    std::uint64_t standard_received;
+    //! duration of the storm in nanoseconds
+    std::uint64_t duration;
+    //! I/O operations interrupted with EINTR
+    std::uint64_t io_interrupted;
+    //! I/O operations that transferred corrupted data
+    std::uint64_t io_errors;
+    //! delivery latency percentiles in nanoseconds (upper bucket bound)
+    std::uint64_t latency_p50;
+    std::uint64_t latency_p99;
+    std::uint64_t latency_p999;
+    std::uint64_t latency_max;
+
+    //! realtime signals that were sent but not received
+    inline std::uint64_t get_realtime_lost( ) const noexcept;
+
+    //! received signals per second
+    double get_throughput( ) const noexcept;
+};
+
+//! print result
+std::ostream& operator<<(std::ostream &stream, const SignalStormResult &result);
+
+/*! \brief Flood a process with signals and verify the deliveries
+ *
+ * Sender threads / processes send the configured signals with sigqueue.
+ * The signal value encodes sender and sequence number, the send time is
+ * stored per sequence number in shared memory (full 64 bit timestamp: the
+ * latency of late deliveries is measured correctly).
+ * The delivery path under test (SignalHandler, PooledSignalHandler,
+ * IoUringSignalSource, ...) must pass every received signal to record().
+ *
+ * After run() the result reports lost and duplicated realtime signals,
+ * throughput and a delivery latency histogram.
+ */
+class SignalStorm
+{
+    private:
+        //! configuration
+        SignalStormConfig config;
+
+        //! received realtime sequence numbers (one byte per sent realtime signal)
+        std::unique_ptr<std::atomic<std::uint8_t>[]> received;
+
+        //! number of entries in received
+        std::size_t received_size;
+
+        //! send times per sent signal (indexed like received, shared with forked senders)
+        std::atomic<std::uint64_t> *send_times;
+
+        //! received standard signals
+        std::atomic<std::uint64_t> standard_received;
+
+        //! duplicates
+        std::atomic<std::uint64_t> realtime_duplicates;
+
+        //! latency histogram (log2 buckets in nanoseconds)
+        std::atomic<std::uint64_t> latency[64];
+
+        //! number of realtime deliveries (used to wait for the end of the storm)
+        std::atomic<std::uint64_t> realtime_deliveries;
+
+    public:
+        /*! \brief create signal storm
+         *
+         * possible_throws:
+         *   std::invalid_argument: invalid configuration
+         *   std::system_error    : mmap failed
+         */
+        explicit SignalStorm(const SignalStormConfig &config);
+
+        //! unmap send times
+        ~SignalStorm( );
+
+        /*! \brief execute storm
+         *
+         * Blocks until all senders are finished and all realtime signals
+         * are received (or timeout_ms expired).
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        SignalStormResult run(unsigned timeout_ms = 5000);
+
+        /*! \brief record received signal
+         *
+         * async-signal-safe
+         */
+        void record(int signal_number, const union sigval &value) noexcept;
+
+        //! record received signal (see above)
+        inline void record(const siginfo_t &info) noexcept;
+
+        //! record received signal (see above)
+        inline void record(const SignalEvent &event) noexcept;
+
+        //! copying not allowed
+        SignalStorm(const SignalStorm &other) = delete;
+        //! copying not allowed
+        SignalStorm& operator=(const SignalStorm &other) = delete;
+};
+
+inline std::uint64_t SignalStormResult::get_realtime_lost( ) const noexcept
+{
+    return realtime_sent - realtime_received;
+}
+
+inline void SignalStorm::record(const siginfo_t &info) noexcept
+{
+    record(info.si_signo, info.si_value);
+}
+
+inline void SignalStorm::record(const SignalEvent &event) noexcept
+{
+    record(event.signal, event.value);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,107 @@
+/*
+ * \file SignalThread.cpp
+ * \brief Source file de::Koesling::Signal::SignalThread
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalThread.hpp"
+#include "SignalHandler.hpp"
+#include "common_header/sysexcept.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+SignalThread::SignalThread(const sigset_t &signals, const SignalThreadConfig &config, bool isolate) :
+        signals(signals),
+        config(config),
+        stop_fd(-1)
+{
+    if (isolate) block(signals);
+
+    stop_fd = eventfd(0, EFD_CLOEXEC);
+    sysexcept(stop_fd == -1, "eventfd", errno);
+
+    try
+    {
+        thread = std::thread(&SignalThread::run, this);
+    }
+    catch (...)
+    {
+        close(stop_fd);
+        throw;
+    }
+
+    try
+    {
+        // apply from here: errors are reported to the caller
+        this->config.apply(thread.native_handle( ));
+    }
+    catch (...)
+    {
+        std::uint64_t value = 1;
+        static_cast<void>(write(stop_fd, &value, sizeof(value)));
+        thread.join( );
+        close(stop_fd);
+        throw;
+    }
+}
+
+SignalThread::~SignalThread( )
+{
+    std::uint64_t value = 1;
+    static_cast<void>(write(stop_fd, &value, sizeof(value)));
+    thread.join( );
+    close(stop_fd);
+}
+
+void SignalThread::run( )
+{
+    // mask used while waiting: current mask without the handled signals
+    sigset_t wait_mask;
+    pthread_sigmask(SIG_SETMASK, nullptr, &wait_mask);
+    for (int i = 1; i < _NSIG; ++i)
+        if (sigismember(&signals, i) == 1) sigdelset(&wait_mask, i);
+
+    pollfd fd;
+    fd.fd = stop_fd;
+    fd.events = POLLIN;
+
+    for (;;)
+    {
+        // signals are only unblocked during ppoll --> handlers run here
+        int temp = ppoll(&fd, 1, nullptr, &wait_mask);
+        if (temp == -1 && errno == EINTR) continue;
+        if (temp == -1)
+        {
+            SignalHandler::get_error_stream( ) << "SignalThread: ppoll failed" << std::endl;
+            return;
+        }
+        if (fd.revents != 0) return;
+    }
+}
+
+void SignalThread::block(const sigset_t &signals)
+{
+    // pthread_sigmask does not use errno
+    int temp = pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    sysexcept(temp != 0, "pthread_sigmask", temp);
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
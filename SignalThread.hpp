@@ -0,0 +1,96 @@
+/*
+ * \file SignalThread.hpp
+ * \brief Header file de::Koesling::Signal::SignalThread
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalThreadConfig.hpp"
+#include <csignal>
+#include <thread>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Dedicated thread for asynchronous signal delivery
+ *
+ * The thread waits with the given signals unblocked. Handlers installed via
+ * SignalHandler::establish() for these signals therefore run on this thread,
+ * as long as the signals are blocked in all other threads.
+ *
+ * With isolation enabled, the constructor blocks the signals in the calling
+ * thread. Threads created afterwards inherit the mask. Create the
+ * SignalThread in main() before any other thread is started to ensure that
+ * the signals are never delivered to another thread (e.g. on isolated cores).
+ *
+ * Thread directed signals (pthread_kill, synchronous faults) are not affected.
+ */
+class SignalThread
+{
+    private:
+        //! signals delivered to this thread
+        sigset_t signals;
+
+        //! affinity and scheduling of the thread
+        SignalThreadConfig config;
+
+        //! eventfd used to stop the thread
+        int stop_fd;
+
+        //! signal thread
+        std::thread thread;
+
+        //! signal thread
+        void run( );
+
+    public:
+        /*! \brief start signal thread
+         *
+         * attributes:
+         *   signals: signals delivered to this thread
+         *   config : affinity and scheduling of the thread
+         *   isolate: block the signals in the calling thread
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        explicit SignalThread(const sigset_t &signals, const SignalThreadConfig &config = SignalThreadConfig( ),
+                bool isolate = true);
+
+        //! stop signal thread (the signals stay blocked in all other threads)
+        ~SignalThread( );
+
+        //! get native handle of the signal thread
+        inline pthread_t get_native_handle( ) noexcept;
+
+        /*! \brief block signals in the calling thread
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        static void block(const sigset_t &signals);
+
+        //! copying not allowed
+        SignalThread(const SignalThread &other) = delete;
+        //! copying not allowed
+        SignalThread& operator=(const SignalThread &other) = delete;
+};
+
+inline pthread_t SignalThread::get_native_handle( ) noexcept
+{
+    return thread.native_handle( );
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
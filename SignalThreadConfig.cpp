@@ -0,0 +1,65 @@
+/*
+ * \file SignalThreadConfig.cpp
+ * \brief Source file de::Koesling::Signal::SignalThreadConfig
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalThreadConfig.hpp"
+#include "common_header/sysexcept.hpp"
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+SignalThreadConfig::SignalThreadConfig( ) noexcept :
+        set_affinity(false),
+        set_scheduling(false),
+        policy(SCHED_OTHER),
+        priority(0)
+{
+    CPU_ZERO(&affinity);
+}
+
+void SignalThreadConfig::add_cpu(int cpu) noexcept
+{
+    CPU_SET(cpu, &affinity);
+    set_affinity = true;
+}
+
+void SignalThreadConfig::use_fifo(int fifo_priority) noexcept
+{
+    policy = SCHED_FIFO;
+    priority = fifo_priority;
+    set_scheduling = true;
+}
+
+void SignalThreadConfig::apply(pthread_t thread) const
+{
+    // pthread functions do not use errno
+    if (set_affinity)
+    {
+        int temp = pthread_setaffinity_np(thread, sizeof(affinity), &affinity);
+        sysexcept(temp != 0, "pthread_setaffinity_np", temp);
+    }
+
+    if (set_scheduling)
+    {
+        sched_param param;
+        param.sched_priority = priority;
+        int temp = pthread_setschedparam(thread, policy, &param);
+        sysexcept(temp != 0, "pthread_setschedparam", temp);
+    }
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,76 @@
+/*
+ * \file SignalThreadConfig.hpp
+ * \brief Header file de::Koesling::Signal::SignalThreadConfig
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief CPU affinity and scheduling policy of a signal processing thread
+ *
+ * Nothing is changed for settings that are not enabled.
+ */
+struct SignalThreadConfig
+{
+    //! apply affinity
+    bool set_affinity;
+    //! CPUs the thread may run on
+    cpu_set_t affinity;
+
+    //! apply scheduling policy and priority
+    bool set_scheduling;
+    //! scheduling policy (see man sched_setscheduler (SCHED_FIFO, SCHED_RR, ...))
+    int policy;
+    //! scheduling priority (see man sched_setscheduler (sched_priority))
+    int priority;
+
+    //! default config: change nothing
+    SignalThreadConfig( ) noexcept;
+
+    //! allow the thread to run on cpu (enables affinity)
+    void add_cpu(int cpu) noexcept;
+
+    //! use SCHED_FIFO with the given priority (enables scheduling)
+    void use_fifo(int fifo_priority) noexcept;
+
+    /*! \brief apply config to a thread
+     *
+     * SCHED_FIFO / SCHED_RR usually require CAP_SYS_NICE.
+     *
+     * possible_throws:
+     *   std::system_error: a system call failed
+     */
+    void apply(pthread_t thread) const;
+
+    /*! \brief apply config to the calling thread
+     *
+     * possible_throws:
+     *   std::system_error: a system call failed
+     */
+    inline void apply( ) const;
+};
+
+inline void SignalThreadConfig::apply( ) const
+{
+    apply(pthread_self( ));
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
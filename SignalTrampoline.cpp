@@ -0,0 +1,72 @@
+/*
+ * \file SignalTrampoline.cpp
+ * \brief Source file de::Koesling::Signal::SignalTrampoline
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "SignalTrampoline.hpp"
+#include <cerrno>
+#include <sched.h>
+#include <stdexcept>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+std::atomic<SignalSink*> SignalTrampoline::sinks[_NSIG];
+constexpr unsigned SignalTrampoline::ACTIVE_SHARDS;
+SignalTrampoline::ActiveCount SignalTrampoline::active[_NSIG][ACTIVE_SHARDS];
+
+void SignalTrampoline::attach(int signal_number, SignalSink *sink)
+{
+    if (signal_number < SIGHUP || signal_number >= _NSIG)
+        throw std::invalid_argument("Invalid signal number (out of range).");
+
+    if (sink == nullptr) throw std::invalid_argument("Unable to attach nullptr as signal sink.");
+
+    SignalSink *expected = nullptr;
+    if (!sinks[signal_number].compare_exchange_strong(expected, sink))
+        throw std::logic_error("Another signal sink is already attached to this signal.");
+}
+
+void SignalTrampoline::detach(int signal_number, SignalSink *sink) noexcept
+{
+    if (signal_number < SIGHUP || signal_number >= _NSIG) return;
+
+    SignalSink *expected = sink;
+    if (!sinks[signal_number].compare_exchange_strong(expected, nullptr)) return;
+
+    // wait for handlers that are still using the sink
+    for (const ActiveCount &shard : active[signal_number])
+        while (shard.count.load( ) != 0)
+            sched_yield( );
+}
+
+void SignalTrampoline::handler(int signal_number, siginfo_t *info, void *context)
+{
+    // the interrupted code must not observe a modified errno
+    const int saved_errno = errno;
+
+    // sched_getcpu is served by rseq / vdso (no system call)
+    const int cpu = sched_getcpu( );
+    ActiveCount &shard = active[signal_number][static_cast<unsigned>(cpu < 0 ? 0 : cpu) % ACTIVE_SHARDS];
+
+    shard.count.fetch_add(1);
+    SignalSink *sink = sinks[signal_number].load( );
+    if (sink != nullptr) sink->on_signal(signal_number, info, context);
+    shard.count.fetch_sub(1);
+
+    errno = saved_errno;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,94 @@
+/*
+ * \file SignalTrampoline.hpp
+ * \brief Header file de::Koesling::Signal::SignalTrampoline
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <csignal>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief receiver of signals that are dispatched by SignalTrampoline
+ *
+ * on_signal() is executed in signal handler context and must be
+ * async-signal-safe.
+ */
+class SignalSink
+{
+    public:
+        virtual ~SignalSink( ) = default;
+
+        //! called by the trampoline (see man sigaction (sa_sigaction))
+        virtual void on_signal(int signal_number, siginfo_t *info, void *context) noexcept = 0;
+};
+
+/*! \brief dispatch signals to objects
+ *
+ * Plain signal handlers can not carry state. The trampoline handler looks up
+ * the SignalSink that is attached to the signal and calls it.
+ *
+ * usage:
+ *   SignalTrampoline::attach(SIGCHLD, &sink);
+ *   SignalHandler handler(SIGCHLD, SignalTrampoline::handler, SA_RESTART);
+ *   handler.establish();
+ */
+class SignalTrampoline
+{
+    private:
+        //! attached sink per signal
+        static std::atomic<SignalSink*> sinks[_NSIG];
+
+        //! number of counter shards per signal
+        static constexpr unsigned ACTIVE_SHARDS = 32;
+
+        //! counter shard (own cache line)
+        struct alignas(64) ActiveCount
+        {
+            std::atomic<unsigned> count;
+        };
+
+        /*! \brief number of handlers that currently use the attached sink (per signal)
+         *
+         * sharded by cpu: handlers on different cpus (sockets) do not share
+         * a cache line
+         */
+        static ActiveCount active[_NSIG][ACTIVE_SHARDS];
+
+    public:
+        SignalTrampoline( ) = delete;
+
+        /*! \brief attach sink to signal
+         *
+         * possible_throws:
+         *   std::invalid_argument: invalid signal number or sink is nullptr
+         *   std::logic_error     : another sink is attached to the signal
+         */
+        static void attach(int signal_number, SignalSink *sink);
+
+        /*! \brief detach sink from signal
+         *
+         * Waits until no signal handler uses the sink anymore.
+         * Nothing happens if the sink is not attached to the signal.
+         */
+        static void detach(int signal_number, SignalSink *sink) noexcept;
+
+        //! signal handler function (SignalHandler_extended_t)
+        static void handler(int signal_number, siginfo_t *info, void *context);
+};
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
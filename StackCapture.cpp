@@ -0,0 +1,74 @@
+/*
+ * \file StackCapture.cpp
+ * \brief Source file de::Koesling::Signal::StackCapture
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *          -rdynamic (symbol names in the output)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "StackCapture.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <string>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+// symbol name of an address (demangled if possible)
+static std::string symbol_name(void *address)
+{
+    Dl_info info;
+    if (dladdr(address, &info) == 0 || info.dli_sname == nullptr)
+    {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%p", address);
+        return buffer;
+    }
+
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string name = status == 0 && demangled != nullptr ? demangled : info.dli_sname;
+    free(demangled);
+    return name;
+}
+
+void StackCapture::prime( ) noexcept
+{
+    void *frames[2];
+    backtrace(frames, 2);
+}
+
+int StackCapture::capture(void **frames, int max_frames) noexcept
+{
+    return backtrace(frames, max_frames);
+}
+
+void StackCapture::write(std::ostream &stream, void *const *frames, int count)
+{
+    for (int i = 0; i < count; ++i)
+        stream << "  #" << i << ' ' << frames[i] << ' ' << symbol_name(frames[i]) << '\n';
+}
+
+void StackCapture::write_folded(std::ostream &stream, void *const *frames, int count)
+{
+    for (int i = count - 1; i >= 0; --i)
+    {
+        stream << symbol_name(frames[i]);
+        if (i != 0) stream << ';';
+    }
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
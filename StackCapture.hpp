@@ -0,0 +1,61 @@
+/*
+ * \file StackCapture.hpp
+ * \brief Header file de::Koesling::Signal::StackCapture
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *
+ * recommended compiler options:
+ *          -O2
+ *          -rdynamic (symbol names in the output)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <ostream>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Stack capture inside signal handlers
+ *
+ * backtrace() is not formally async-signal-safe: the first call loads the
+ * unwinder (dlopen, malloc). prime() performs this first call outside of
+ * signal handler context. Afterwards capture() does not allocate memory.
+ * (It still must not interrupt the dynamic loader.)
+ */
+class StackCapture
+{
+    public:
+        StackCapture( ) = delete;
+
+        //! load the unwinder (call before the first capture() in a signal handler)
+        static void prime( ) noexcept;
+
+        /*! \brief capture return addresses of the calling thread
+         *
+         * Returns the number of addresses stored in frames.
+         * async-signal-safe (after prime())
+         */
+        static int capture(void **frames, int max_frames) noexcept;
+
+        /*! \brief write captured addresses with symbol names
+         *
+         * Not async-signal-safe.
+         */
+        static void write(std::ostream &stream, void *const *frames, int count);
+
+        /*! \brief write captured addresses as folded stack (root first, separated by ';')
+         *
+         * Not async-signal-safe.
+         */
+        static void write_folded(std::ostream &stream, void *const *frames, int count);
+};
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,84 @@
+/*
+ * \file ThreadKicker.cpp
+ * \brief Source file de::Koesling::Signal::ThreadKicker
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "ThreadKicker.hpp"
+#include "InterruptibleIo.hpp"
+#include "RealtimeSignals.hpp"
+#include "common_header/sysexcept.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <sysexits.h>
+#include <thread>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+ThreadKicker::ThreadKicker( ) :
+        signal_number(RealtimeSignals::reserve( )),
+        signal_handler(signal_number, handler, 0)	// no SA_RESTART: interrupt blocking system calls
+{
+    try
+    {
+        signal_handler.establish( );
+    }
+    catch (...)
+    {
+        RealtimeSignals::release(signal_number);
+        throw;
+    }
+}
+
+ThreadKicker::~ThreadKicker( )
+{
+    try
+    {
+        signal_handler.revoke( );
+    }
+    catch (const std::exception &e) // system call failed
+    {
+        destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+    }
+    RealtimeSignals::release(signal_number);
+}
+
+void ThreadKicker::handler(int)
+{
+    // the delivery itself interrupts the system call, the request stops the retry of InterruptibleIo
+    InterruptibleIo::interrupt( );
+}
+
+void ThreadKicker::kick(pthread_t thread)
+{
+    // pthread_kill does not use errno
+    int temp = pthread_kill(thread, signal_number);
+    sysexcept(temp != 0, "pthread_kill", temp);
+}
+
+bool ThreadKicker::kick_until(pthread_t thread, const std::atomic<bool> &done, std::chrono::milliseconds timeout,
+        std::chrono::microseconds interval)
+{
+    const auto deadline = std::chrono::steady_clock::now( ) + timeout;
+    while (!done.load( ))
+    {
+        if (std::chrono::steady_clock::now( ) >= deadline) return false;
+        kick(thread);
+        std::this_thread::sleep_for(interval);
+    }
+    return true;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,101 @@
+/*
+ * \file ThreadKicker.hpp
+ * \brief Header file de::Koesling::Signal::ThreadKicker
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "SignalHandler.hpp"
+#include <atomic>
+#include <chrono>
+#include <pthread.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Wake up threads that are blocked in system calls
+ *
+ * A reserved realtime signal is installed without SA_RESTART and with an
+ * empty handler. kick() sends it to a thread: a blocking read, accept,
+ * nanosleep, ... of this thread fails with EINTR. The wrappers of
+ * InterruptibleIo do not retry such calls (the handler calls
+ * InterruptibleIo::interrupt()).
+ *
+ * A kick that arrives before the thread enters the blocking call is lost.
+ * The target thread must therefore check its stop condition before every
+ * blocking call, and the caller should use kick_until() which repeats the
+ * kick until the thread acknowledged it.
+ */
+class ThreadKicker
+{
+    private:
+        //! reserved realtime signal
+        int signal_number;
+
+        //! installed empty handler
+        SignalHandler signal_handler;
+
+        //! empty signal handler
+        static void handler(int signal_number);
+
+    public:
+        /*! \brief reserve signal and install handler
+         *
+         * possible_throws:
+         *   std::runtime_error: no free realtime signal
+         *   std::system_error : a system call failed
+         */
+        ThreadKicker( );
+
+        //! revoke handler and release signal
+        ~ThreadKicker( );
+
+        /*! \brief interrupt the blocking system call of a thread
+         *
+         * Not reliable on its own: the kick is lost if it arrives before the
+         * thread blocks in the system call (also with InterruptibleIo, after
+         * its request check). Only kick_until() reliably wakes the thread.
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed (e.g. thread does not exist)
+         */
+        void kick(pthread_t thread);
+
+        /*! \brief kick thread repeatedly until done is set
+         *
+         * returns false if done was not set within timeout
+         *
+         * possible_throws:
+         *   std::system_error: a system call failed
+         */
+        bool kick_until(pthread_t thread, const std::atomic<bool> &done, std::chrono::milliseconds timeout,
+                std::chrono::microseconds interval = std::chrono::microseconds(1000));
+
+        //! get the reserved signal
+        inline int get_signal_number( ) const noexcept;
+
+        //! copying not allowed
+        ThreadKicker(const ThreadKicker &other) = delete;
+        //! copying not allowed
+        ThreadKicker& operator=(const ThreadKicker &other) = delete;
+};
+
+inline int ThreadKicker::get_signal_number( ) const noexcept
+{
+    return signal_number;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,261 @@
+/*
+ * \file ThreadWatchdog.cpp
+ * \brief Source file de::Koesling::Signal::ThreadWatchdog
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *          -rdynamic (symbol names in the default report)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "ThreadWatchdog.hpp"
+#include "RealtimeSignals.hpp"
+#include "StackCapture.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <sys/syscall.h>
+#include <sysexits.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+constexpr int ThreadWatchdog::MAX_FRAMES;
+
+//! maximum time the monitor waits for the stack capture of a stalled thread
+static constexpr std::chrono::milliseconds CAPTURE_TIMEOUT(100);
+
+ThreadWatchdog::Registration::Registration(ThreadWatchdog *watchdog, Entry *entry) noexcept :
+        watchdog(watchdog),
+        entry(entry)
+{ }
+
+ThreadWatchdog::Registration::Registration(Registration &&other) noexcept :
+        watchdog(other.watchdog),
+        entry(other.entry)
+{
+    other.watchdog = nullptr;
+    other.entry = nullptr;
+}
+
+ThreadWatchdog::Registration::~Registration( )
+{
+    if (watchdog != nullptr) watchdog->unregister(entry);
+}
+
+ThreadWatchdog::ThreadWatchdog(std::chrono::milliseconds timeout, ReportFunction_t report_function) :
+        timeout(timeout),
+        report_function(report_function ? std::move(report_function) : write_report),
+        signal_number(RealtimeSignals::reserve( )),
+        stop(false),
+        signal_handler(signal_number, SignalTrampoline::handler, SA_RESTART)
+{
+    StackCapture::prime( );
+
+    try
+    {
+        SignalTrampoline::attach(signal_number, this);
+        try
+        {
+            signal_handler.establish( );
+            monitor = std::thread(&ThreadWatchdog::run, this);
+        }
+        catch (...)
+        {
+            if (signal_handler.is_established( )) signal_handler.revoke( );
+            SignalTrampoline::detach(signal_number, this);
+            throw;
+        }
+    }
+    catch (...)
+    {
+        RealtimeSignals::release(signal_number);
+        throw;
+    }
+}
+
+ThreadWatchdog::~ThreadWatchdog( )
+{
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex);
+        stop = true;
+    }
+    stop_condition.notify_all( );
+    monitor.join( );
+
+    try
+    {
+        signal_handler.revoke( );
+    }
+    catch (const std::exception &e) // system call failed
+    {
+        destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+    }
+    SignalTrampoline::detach(signal_number, this);
+    RealtimeSignals::release(signal_number);
+}
+
+ThreadWatchdog::Registration ThreadWatchdog::register_thread(const std::string &name)
+{
+    const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+
+    std::lock_guard<std::mutex> lock(entries_mutex);
+    for (const auto &other : entries)
+        if (other->active && other->tid == tid) throw std::logic_error("Thread is already registered.");
+
+    // reuse entry of an unregistered thread without pending capture
+    Entry *entry = nullptr;
+    for (auto &candidate : entries)
+        if (!candidate->active && !candidate->collecting && candidate->capture.load( ) != REQUESTED)
+        {
+            entry = candidate.get( );
+            break;
+        }
+
+    if (entry == nullptr)
+    {
+        entries.emplace_back(HugePageArena::create<Entry>( ));
+        entry = entries.back( ).get( );
+    }
+
+    entry->name = name;
+    entry->thread = pthread_self( );
+    entry->tid = tid;
+    entry->heartbeat.store(0);
+    entry->last_heartbeat = 0;
+    entry->last_change = std::chrono::steady_clock::now( );
+    entry->reported = false;
+    entry->collecting = false;
+    entry->capture.store(IDLE);
+    entry->frame_count = 0;
+    entry->active = true;
+
+    return Registration(this, entry);
+}
+
+void ThreadWatchdog::unregister(Entry *entry) noexcept
+{
+    // the entry is kept: a requested capture may still be delivered
+    std::lock_guard<std::mutex> lock(entries_mutex);
+    entry->active = false;
+}
+
+void ThreadWatchdog::on_signal(int, siginfo_t *info, void*) noexcept
+{
+    // only accept requests of the monitor thread
+    if (info->si_code != SI_QUEUE || info->si_pid != getpid( )) return;
+
+    Entry *entry = static_cast<Entry*>(info->si_value.sival_ptr);
+    if (entry->capture.load(std::memory_order_acquire) != REQUESTED) return;
+
+    entry->frame_count = StackCapture::capture(entry->frames, MAX_FRAMES);
+    entry->capture.store(DONE, std::memory_order_release);
+}
+
+void ThreadWatchdog::run( )
+{
+    const std::chrono::milliseconds period = std::max(timeout / 4, std::chrono::milliseconds(1));
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(stop_mutex);
+            if (stop_condition.wait_for(lock, period, [this]( ) { return stop; })) return;
+        }
+
+        // detect stalls and request stack captures
+        std::vector<StallReport> reports;
+        std::vector<Entry*> stalled;
+        {
+            std::lock_guard<std::mutex> lock(entries_mutex);
+            const auto now = std::chrono::steady_clock::now( );
+
+            for (auto &entry : entries)
+            {
+                if (!entry->active) continue;
+
+                const std::uint64_t heartbeat = entry->heartbeat.load(std::memory_order_relaxed);
+                if (heartbeat != entry->last_heartbeat)
+                {
+                    entry->last_heartbeat = heartbeat;
+                    entry->last_change = now;
+                    entry->reported = false;
+                    continue;
+                }
+
+                if (entry->reported || now - entry->last_change < timeout) continue;
+                entry->reported = true;
+
+                StallReport report;
+                report.name = entry->name;
+                report.thread = entry->tid;
+                report.stalled_for = std::chrono::duration_cast<std::chrono::milliseconds>(now - entry->last_change);
+                reports.push_back(std::move(report));
+
+                // a capture request that timed out before is still pending --> no stack
+                entry->collecting = true;
+                stalled.push_back(entry.get( ));
+                if (entry->capture.load( ) == REQUESTED) continue;
+
+                entry->capture.store(REQUESTED);
+                union sigval value;
+                value.sival_ptr = entry.get( );
+                if (pthread_sigqueue(entry->thread, signal_number, value) != 0) entry->capture.store(IDLE);
+            }
+        }
+
+        if (stalled.empty( )) continue;
+
+        // wait for the captures without blocking register_thread() / unregister()
+        const auto deadline = std::chrono::steady_clock::now( ) + CAPTURE_TIMEOUT;
+        for (;;)
+        {
+            bool pending = false;
+            for (Entry *entry : stalled)
+                if (entry->capture.load(std::memory_order_acquire) == REQUESTED) pending = true;
+            if (!pending || std::chrono::steady_clock::now( ) >= deadline) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(entries_mutex);
+            for (std::size_t i = 0; i < stalled.size( ); ++i)
+            {
+                Entry *entry = stalled[i];
+                entry->collecting = false;
+
+                // not done: the request stays pending, the entry is not reused until it arrives
+                if (entry->capture.load(std::memory_order_acquire) != DONE) continue;
+                reports[i].frames.assign(entry->frames, entry->frames + entry->frame_count);
+                entry->capture.store(IDLE);
+            }
+        }
+
+        for (const auto &report : reports)
+            report_function(report);
+    }
+}
+
+void ThreadWatchdog::write_report(const StallReport &report)
+{
+    std::ostream &stream = SignalHandler::get_error_stream( );
+    stream << "ThreadWatchdog: thread '" << report.name << "' (" << report.thread << ") stalled for "
+            << report.stalled_for.count( ) << " ms\n";
+    if (report.frames.empty( ))
+        stream << "  (no stack captured)\n";
+    else
+        StackCapture::write(stream, report.frames.data( ), static_cast<int>(report.frames.size( )));
+    stream.flush( );
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
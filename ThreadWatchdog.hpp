@@ -0,0 +1,216 @@
+/*
+ * \file ThreadWatchdog.hpp
+ * \brief Header file de::Koesling::Signal::ThreadWatchdog
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *          -rdynamic (symbol names in the default report)
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "HugePageArena.hpp"
+#include "SignalHandler.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <pthread.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! report of a stalled thread
+struct StallReport
+{
+    //! name given at registration
+    std::string name;
+    //! kernel thread id
+    pid_t thread;
+    //! time since the last heartbeat
+    std::chrono::milliseconds stalled_for;
+    //! captured return addresses (empty if the thread did not respond)
+    std::vector<void*> frames;
+};
+
+/*! \brief Detect stalled threads and capture their stacks
+ *
+ * Registered threads call beat() regularly. A monitor thread checks the
+ * heartbeats periodically. If the heartbeat of a thread did not change
+ * within the timeout, the monitor sends a reserved realtime signal to the
+ * thread. The handler captures the stack of the thread into a preallocated
+ * buffer. The monitor then passes a StallReport to the report function
+ * (once per stall).
+ *
+ * Threads that block the reserved signal are reported without stack.
+ * Entries are kept until the watchdog is destroyed, so a capture request
+ * that is delivered after the thread unregistered stays harmless.
+ */
+class ThreadWatchdog : private SignalSink
+{
+    public:
+        //! maximum number of captured frames
+        static constexpr int MAX_FRAMES = 64;
+
+        //! report function type
+        typedef std::function<void(const StallReport&)> ReportFunction_t;
+
+    private:
+        //! stack capture state of an entry
+        enum CaptureState
+        {
+            IDLE,	//!< no capture requested
+            REQUESTED,	//!< signal sent, capture not done yet
+            DONE	//!< frames written by the signal handler
+        };
+
+        //! state of a registered thread (never released before the ThreadWatchdog object)
+        struct Entry
+        {
+            std::string name;
+            pthread_t thread;
+            pid_t tid;
+            std::atomic<std::uint64_t> heartbeat;
+
+            //! thread is registered (entries of unregistered threads are reused)
+            bool active;
+
+            //! monitor state
+            std::uint64_t last_heartbeat;
+            std::chrono::steady_clock::time_point last_change;
+            bool reported;
+            bool collecting;
+
+            //! stack capture (frames written by the signal handler)
+            std::atomic<int> capture;
+            int frame_count;
+            void *frames[MAX_FRAMES];
+        };
+
+    public:
+        /*! \brief registration of a thread
+         *
+         * The thread is unregistered by the destructor.
+         */
+        class Registration
+        {
+            private:
+                ThreadWatchdog *watchdog;
+                Entry *entry;
+
+                friend class ThreadWatchdog;
+                Registration(ThreadWatchdog *watchdog, Entry *entry) noexcept;
+
+            public:
+                //! unregister thread
+                ~Registration( );
+
+                //! signal progress
+                inline void beat( ) noexcept;
+
+                //! copying not allowed
+                Registration(const Registration &other) = delete;
+                //! copying not allowed
+                Registration& operator=(const Registration &other) = delete;
+
+                //! move this object
+                Registration(Registration &&other) noexcept;
+        };
+
+    private:
+        //! stall timeout
+        std::chrono::milliseconds timeout;
+
+        //! report function
+        ReportFunction_t report_function;
+
+        //! reserved realtime signal
+        int signal_number;
+
+        //! registered threads (allocated by HugePageArena::create())
+        std::vector<std::unique_ptr<Entry, HugePageArena::Deleter>> entries;
+        std::mutex entries_mutex;
+
+        //! stop monitor
+        bool stop;
+        std::mutex stop_mutex;
+        std::condition_variable stop_condition;
+
+        //! stack capture handler
+        SignalHandler signal_handler;
+
+        //! monitor thread
+        std::thread monitor;
+
+        //! capture stack (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+        //! monitor thread
+        void run( );
+
+        //! unregister entry
+        void unregister(Entry *entry) noexcept;
+
+    public:
+        /*! \brief create and start watchdog
+         *
+         * attributes:
+         *   timeout        : heartbeat timeout
+         *   report_function: called by the monitor thread for every stall
+         *                    (nullptr: write report to SignalHandler error stream)
+         * possible_throws:
+         *   std::runtime_error: no free realtime signal
+         *   std::system_error : a system call failed
+         */
+        explicit ThreadWatchdog(std::chrono::milliseconds timeout, ReportFunction_t report_function = nullptr);
+
+        //! stop watchdog (all registrations must be destroyed before)
+        ~ThreadWatchdog( );
+
+        /*! \brief register the calling thread
+         *
+         * possible_throws:
+         *   std::logic_error: thread is already registered
+         */
+        Registration register_thread(const std::string &name);
+
+        //! get the reserved signal
+        inline int get_signal_number( ) const noexcept;
+
+        //! default report function (writes to SignalHandler error stream)
+        static void write_report(const StallReport &report);
+
+        //! copying not allowed
+        ThreadWatchdog(const ThreadWatchdog &other) = delete;
+        //! copying not allowed
+        ThreadWatchdog& operator=(const ThreadWatchdog &other) = delete;
+};
+
+inline void ThreadWatchdog::Registration::beat( ) noexcept
+{
+    entry->heartbeat.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline int ThreadWatchdog::get_signal_number( ) const noexcept
+{
+    return signal_number;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
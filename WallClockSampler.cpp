@@ -0,0 +1,326 @@
+/*
+ * \file WallClockSampler.cpp
+ * \brief Source file de::Koesling::Signal::WallClockSampler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "WallClockSampler.hpp"
+#include "RealtimeSignals.hpp"
+#include "StackCapture.hpp"
+#include "common_header/destructor_exception.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <sys/uio.h>
+#include <sysexits.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+constexpr int WallClockSampler::MAX_FRAMES;
+
+//! maximum time to wait for the handlers of one sampling round
+static constexpr std::chrono::milliseconds COLLECT_TIMEOUT(50);
+
+/*! \brief read two instruction bytes without faulting
+ *
+ * The bytes before the interrupted instruction may be located on an
+ * unmapped page. process_vm_readv reports EFAULT instead (async-signal-safe
+ * system call).
+ */
+static bool read_code(const unsigned char *address, unsigned char (&bytes)[2]) noexcept
+{
+    struct iovec local = { bytes, sizeof(bytes) };
+    struct iovec remote = { const_cast<unsigned char*>(address), sizeof(bytes) };
+    return process_vm_readv(getpid( ), &local, 1, &remote, 1, 0) == static_cast<ssize_t>(sizeof(bytes));
+}
+
+/*! \brief get interrupted instruction and check if the thread was in a system call
+ *
+ * The kernel reports the address of the syscall instruction (0f 05) if the
+ * system call is restarted (SA_RESTART) and the address after it if the
+ * system call returns. In the second case rax holds the result: only
+ * -EINTR (or a not yet converted -ERESTART* code) identifies an interrupted
+ * system call, other instructions may end with the bytes 0f 05 as well.
+ */
+static void* interrupted_at(void *context, bool &in_syscall) noexcept
+{
+    in_syscall = false;
+#if defined(__x86_64__)
+    // kernel internal restart codes (ERESTARTSYS .. ERESTART_RESTARTBLOCK)
+    static constexpr long ERESTART_FIRST = 512;
+    static constexpr long ERESTART_LAST = 516;
+
+    const ucontext_t *uc = static_cast<const ucontext_t*>(context);
+    const unsigned char *ip = reinterpret_cast<const unsigned char*>(uc->uc_mcontext.gregs[REG_RIP]);
+    const long result = static_cast<long>(uc->uc_mcontext.gregs[REG_RAX]);
+    const bool interrupted = result == -EINTR || (result <= -ERESTART_FIRST && result >= -ERESTART_LAST);
+
+    unsigned char bytes[2];
+    in_syscall = (interrupted && read_code(ip - 2, bytes) && bytes[0] == 0x0f && bytes[1] == 0x05)
+            || (read_code(ip, bytes) && bytes[0] == 0x0f && bytes[1] == 0x05);
+    return const_cast<unsigned char*>(ip);
+#else
+    static_cast<void>(context);
+    return nullptr;
+#endif
+}
+
+WallClockSampler::Registration::Registration(WallClockSampler *sampler, Entry *entry) noexcept :
+        sampler(sampler),
+        entry(entry)
+{
+}
+
+WallClockSampler::Registration::Registration(Registration &&other) noexcept :
+        sampler(other.sampler),
+        entry(other.entry)
+{
+    other.sampler = nullptr;
+    other.entry = nullptr;
+}
+
+WallClockSampler::Registration::~Registration( )
+{
+    if (sampler != nullptr) sampler->unregister(entry);
+}
+
+WallClockSampler::WallClockSampler(std::chrono::microseconds period) :
+        period(period),
+        signal_number(RealtimeSignals::reserve( )),
+        missed(0),
+        stop(false),
+        signal_handler(signal_number, SignalTrampoline::handler, SA_RESTART)
+{
+    StackCapture::prime( );
+
+    try
+    {
+        SignalTrampoline::attach(signal_number, this);
+        try
+        {
+            signal_handler.establish( );
+            monitor = std::thread(&WallClockSampler::run, this);
+        }
+        catch (...)
+        {
+            if (signal_handler.is_established( )) signal_handler.revoke( );
+            SignalTrampoline::detach(signal_number, this);
+            throw;
+        }
+    }
+    catch (...)
+    {
+        RealtimeSignals::release(signal_number);
+        throw;
+    }
+}
+
+WallClockSampler::~WallClockSampler( )
+{
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex);
+        stop = true;
+    }
+    stop_condition.notify_all( );
+    monitor.join( );
+
+    try
+    {
+        signal_handler.revoke( );
+    }
+    catch (const std::exception &e) // system call failed
+    {
+        destructor_exception_terminate(e, SignalHandler::get_error_stream( ), EX_OSERR);
+    }
+    SignalTrampoline::detach(signal_number, this);
+    RealtimeSignals::release(signal_number);
+}
+
+WallClockSampler::Registration WallClockSampler::register_thread(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(entries_mutex);
+
+    // reuse entry of an unregistered thread without pending request
+    Entry *entry = nullptr;
+    for (auto &candidate : entries)
+        if (!candidate->active && candidate->state.load( ) == IDLE)
+        {
+            entry = candidate.get( );
+            break;
+        }
+
+    if (entry == nullptr)
+    {
+        entries.emplace_back(HugePageArena::create<Entry>( ));
+        entry = entries.back( ).get( );
+        entry->state.store(IDLE);
+    }
+
+    entry->name = name;
+    entry->thread = pthread_self( );
+    entry->in_syscall = false;
+    entry->frame_count = 0;
+    entry->active = true;
+
+    return Registration(this, entry);
+}
+
+void WallClockSampler::unregister(Entry *entry) noexcept
+{
+    // the entry is kept: a requested sample may still be delivered
+    std::lock_guard<std::mutex> lock(entries_mutex);
+    entry->active = false;
+}
+
+void WallClockSampler::on_signal(int, siginfo_t *info, void *context) noexcept
+{
+    // only accept requests of the monitor thread
+    if (info->si_code != SI_QUEUE || info->si_pid != getpid( )) return;
+
+    Entry *entry = static_cast<Entry*>(info->si_value.sival_ptr);
+    if (entry->state.load(std::memory_order_acquire) != REQUESTED) return;
+
+    bool in_syscall;
+    void *ip = interrupted_at(context, in_syscall);
+    int count = StackCapture::capture(entry->frames, MAX_FRAMES);
+
+    // drop the frames of the signal handler (up to the interrupted instruction)
+    for (int i = 0; i < count; ++i)
+    {
+        if (entry->frames[i] != ip) continue;
+        memmove(entry->frames, entry->frames + i, static_cast<std::size_t>(count - i) * sizeof(void*));
+        count -= i;
+        break;
+    }
+
+    entry->in_syscall = in_syscall;
+    entry->frame_count = count;
+    entry->state.store(DONE, std::memory_order_release);
+}
+
+void WallClockSampler::collect(Entry &entry)
+{
+    Key_t key(entry.in_syscall, entry.name, std::vector<void*>(entry.frames, entry.frames + entry.frame_count));
+    entry.state.store(IDLE, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(samples_mutex);
+    ++samples[key];
+}
+
+void WallClockSampler::run( )
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(stop_mutex);
+            if (stop_condition.wait_for(lock, period, [this]( ) { return stop; })) return;
+        }
+
+        // request all samples first: the threads are sampled (almost) at the same time
+        std::vector<Entry*> requested;
+        {
+            std::lock_guard<std::mutex> lock(entries_mutex);
+            for (auto &entry : entries)
+            {
+                // finished after the timeout of an earlier round
+                if (entry->state.load(std::memory_order_acquire) == DONE) collect(*entry);
+
+                if (!entry->active || entry->state.load( ) != IDLE) continue;
+
+                entry->state.store(REQUESTED);
+                union sigval value;
+                value.sival_ptr = entry.get( );
+                if (pthread_sigqueue(entry->thread, signal_number, value) != 0)
+                    entry->state.store(IDLE);
+                else
+                    requested.push_back(entry.get( ));
+            }
+        }
+
+        // wait without the lock: (un)registration must not stall for a slow sample
+        // (requested entries are not reused or modified before they are collected)
+        const auto deadline = std::chrono::steady_clock::now( ) + std::min<std::chrono::microseconds>(period,
+                COLLECT_TIMEOUT);
+        std::size_t pending = requested.size( );
+        while (pending != 0)
+        {
+            for (Entry *&entry : requested)
+            {
+                if (entry == nullptr || entry->state.load(std::memory_order_acquire) != DONE) continue;
+                collect(*entry);
+                entry = nullptr;
+                --pending;
+            }
+            if (pending == 0 || std::chrono::steady_clock::now( ) >= deadline) break;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        if (pending != 0)
+        {
+            // threads that were unregistered meanwhile are not counted
+            std::uint64_t count = 0;
+            {
+                std::lock_guard<std::mutex> lock(entries_mutex);
+                for (Entry *entry : requested)
+                    if (entry != nullptr && entry->active && entry->state.load( ) == REQUESTED) ++count;
+            }
+
+            std::lock_guard<std::mutex> samples_lock(samples_mutex);
+            missed += count;
+        }
+    }
+}
+
+void WallClockSampler::write_folded(std::ostream &stream) const
+{
+    // samples are aggregated by address: merge stacks with the same symbols
+    std::map<std::string, std::uint64_t> folded;
+    {
+        std::lock_guard<std::mutex> lock(samples_mutex);
+        for (const auto &sample : samples)
+        {
+            const std::vector<void*> &frames = std::get<2>(sample.first);
+            std::ostringstream line;
+            line << (std::get<0>(sample.first) ? "off-cpu;" : "on-cpu;") << std::get<1>(sample.first);
+            if (!frames.empty( ))
+            {
+                line << ';';
+                StackCapture::write_folded(line, frames.data( ), static_cast<int>(frames.size( )));
+            }
+            folded[line.str( )] += sample.second;
+        }
+    }
+
+    for (const auto &line : folded)
+        stream << line.first << ' ' << line.second << '\n';
+}
+
+std::uint64_t WallClockSampler::get_missed( ) const
+{
+    std::lock_guard<std::mutex> lock(samples_mutex);
+    return missed;
+}
+
+void WallClockSampler::reset( )
+{
+    std::lock_guard<std::mutex> lock(samples_mutex);
+    samples.clear( );
+    missed = 0;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,204 @@
+/*
+ * \file WallClockSampler.hpp
+ * \brief Header file de::Koesling::Signal::WallClockSampler
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include "HugePageArena.hpp"
+#include "SignalHandler.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <pthread.h>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Wall clock (on- and off-cpu) sampling profiler
+ *
+ * A monitor thread sends a reserved realtime signal to every registered
+ * thread at a fixed period. The handler captures the stack of the thread
+ * into a preallocated buffer and checks (in the ucontext_t) if the thread
+ * was interrupted in a system call. Blocked threads (system call) are
+ * counted as off-cpu, all others as on-cpu. The samples are aggregated per
+ * thread name and stack and written as folded stacks (flamegraph.pl).
+ *
+ * System call detection (x86_64 only, all samples are on-cpu on other
+ * architectures) is a heuristic based on the interrupted context: the
+ * thread is in a system call if the interrupted instruction is a syscall
+ * instruction (restarted system call), or if the preceding instruction is
+ * a syscall instruction and rax holds -EINTR (interrupted system call).
+ * The instruction bytes are read fault-safe (process_vm_readv). Threads
+ * that block the signal are not sampled.
+ */
+class WallClockSampler : private SignalSink
+{
+    public:
+        //! maximum number of captured frames
+        static constexpr int MAX_FRAMES = 64;
+
+    private:
+        //! sample states
+        enum : std::uint32_t
+        {
+            IDLE,      //!< no sample requested
+            REQUESTED, //!< signal sent
+            DONE       //!< sample written by the handler
+        };
+
+        //! state of a registered thread (never released before the sampler)
+        struct Entry
+        {
+            std::string name;
+            pthread_t thread;
+            bool active;
+
+            //! sample (written by the signal handler)
+            std::atomic<std::uint32_t> state;
+            bool in_syscall;
+            int frame_count;
+            void *frames[MAX_FRAMES];
+        };
+
+        //! aggregation key: off-cpu, thread name, frames
+        typedef std::tuple<bool, std::string, std::vector<void*>> Key_t;
+
+    public:
+        /*! \brief registration of a thread
+         *
+         * The thread is unregistered by the destructor.
+         */
+        class Registration
+        {
+            private:
+                WallClockSampler *sampler;
+                Entry *entry;
+
+                friend class WallClockSampler;
+                Registration(WallClockSampler *sampler, Entry *entry) noexcept;
+
+            public:
+                //! unregister thread
+                ~Registration( );
+
+                //! copying not allowed
+                Registration(const Registration &other) = delete;
+                //! copying not allowed
+                Registration& operator=(const Registration &other) = delete;
+
+                //! move this object
+                Registration(Registration &&other) noexcept;
+        };
+
+    private:
+        //! sampling period
+        std::chrono::microseconds period;
+
+        //! reserved realtime signal
+        int signal_number;
+
+        //! registered threads (samples are written to handler memory, see HugePageArena)
+        std::vector<std::unique_ptr<Entry, HugePageArena::Deleter>> entries;
+        std::mutex entries_mutex;
+
+        //! aggregated samples
+        std::map<Key_t, std::uint64_t> samples;
+        std::uint64_t missed;
+        mutable std::mutex samples_mutex;
+
+        //! stop monitor
+        bool stop;
+        std::mutex stop_mutex;
+        std::condition_variable stop_condition;
+
+        //! sampling handler
+        SignalHandler signal_handler;
+
+        //! monitor thread
+        std::thread monitor;
+
+        //! capture sample (signal handler context)
+        void on_signal(int signal_number, siginfo_t *info, void *context) noexcept override;
+
+        //! monitor thread
+        void run( );
+
+        //! collect finished sample of entry (state DONE: not modified by (un)registration)
+        void collect(Entry &entry);
+
+        //! unregister entry
+        void unregister(Entry *entry) noexcept;
+
+    public:
+        /*! \brief create and start sampler
+         *
+         * attributes:
+         *   period: sampling period
+         * possible_throws:
+         *   std::runtime_error: no free realtime signal
+         *   std::system_error : a system call failed
+         */
+        explicit WallClockSampler(std::chrono::microseconds period = std::chrono::milliseconds(10));
+
+        //! stop sampler (all registrations must be destroyed before)
+        ~WallClockSampler( );
+
+        /*! \brief register the calling thread
+         *
+         * possible_throws:
+         *   std::bad_alloc: out of memory
+         */
+        Registration register_thread(const std::string &name);
+
+        /*! \brief write aggregated samples as folded stacks
+         *
+         * format: "on-cpu;<thread name>;<root frame>;...;<leaf frame> <count>"
+         *         (off-cpu samples start with "off-cpu")
+         */
+        void write_folded(std::ostream &stream) const;
+
+        //! get number of samples that were not taken (thread did not respond in time)
+        std::uint64_t get_missed( ) const;
+
+        //! discard aggregated samples
+        void reset( );
+
+        //! get the reserved signal
+        inline int get_signal_number( ) const noexcept;
+
+        //! copying not allowed
+        WallClockSampler(const WallClockSampler &other) = delete;
+        //! copying not allowed
+        WallClockSampler& operator=(const WallClockSampler &other) = delete;
+};
+
+inline int WallClockSampler::get_signal_number( ) const noexcept
+{
+    return signal_number;
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,248 @@
+/*
+ * \file WorkStealingPool.cpp
+ * \brief Source file de::Koesling::Signal::WorkStealingPool
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "WorkStealingPool.hpp"
+#include "SignalHandler.hpp"
+#include <exception>
+#include <stdexcept>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+//! pool and worker index of the calling thread (if it is a worker thread)
+static thread_local const WorkStealingPool *current_pool = nullptr;
+static thread_local std::size_t current_worker = 0;
+
+//! maximum number of strand tasks executed before the strand is rescheduled
+static constexpr std::size_t STRAND_BATCH = 64;
+
+WorkStealingPool::WorkStealingPool(std::size_t threads, std::size_t strands) :
+        pending(0),
+        queued(0),
+        next_worker(0),
+        stop(false)
+{
+    if (strands == 0) throw std::invalid_argument("WorkStealingPool: number of strands must not be 0.");
+
+    if (threads == 0) threads = std::thread::hardware_concurrency( );
+    if (threads == 0) threads = 1;
+
+    for (std::size_t i = 0; i < threads; ++i)
+        workers.emplace_back(new Worker);
+
+    for (std::size_t i = 0; i < strands; ++i)
+        this->strands.emplace_back(new Strand);
+
+    try
+    {
+        for (std::size_t i = 0; i < threads; ++i)
+            this->threads.emplace_back(&WorkStealingPool::run_worker, this, i);
+    }
+    catch (...)
+    {
+        {
+            std::lock_guard<std::mutex> lock(idle_mutex);
+            stop = true;
+        }
+        idle_condition.notify_all( );
+        for (auto &thread : this->threads)
+            thread.join( );
+        throw;
+    }
+}
+
+WorkStealingPool::~WorkStealingPool( )
+{
+    wait_idle( );
+
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+        stop = true;
+    }
+    idle_condition.notify_all( );
+
+    for (auto &thread : threads)
+        thread.join( );
+}
+
+void WorkStealingPool::submit(Task_t task)
+{
+    // workers push to their own deque, other threads distribute round robin
+    const std::size_t index =
+            current_pool == this ?
+                    current_worker : next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size( );
+
+    pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+        queued.fetch_add(1);
+    }
+
+    // synchronize with workers that are about to sleep
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex);
+    }
+    idle_condition.notify_one( );
+}
+
+void WorkStealingPool::submit(std::uint64_t key, Task_t task)
+{
+    Strand &strand = *strands[std::hash<std::uint64_t>( )(key) % strands.size( )];
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(strand.mutex);
+        strand.tasks.push_back(std::move(task));
+        if (!strand.scheduled)
+        {
+            strand.scheduled = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule) submit([this, &strand]( ) { run_strand(strand); });
+}
+
+void WorkStealingPool::run_strand(Strand &strand)
+{
+    for (std::size_t i = 0; i < STRAND_BATCH; ++i)
+    {
+        Task_t task;
+        {
+            std::lock_guard<std::mutex> lock(strand.mutex);
+            if (strand.tasks.empty( ))
+            {
+                strand.scheduled = false;
+                return;
+            }
+            task = std::move(strand.tasks.front( ));
+            strand.tasks.pop_front( );
+        }
+        execute(task);
+    }
+
+    // give other tasks a chance --> reschedule strand (still marked as scheduled)
+    submit([this, &strand]( ) { run_strand(strand); });
+}
+
+bool WorkStealingPool::next_task(std::size_t index, Task_t &task)
+{
+    // own deque: LIFO
+    {
+        Worker &worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty( ))
+        {
+            task = std::move(worker.tasks.back( ));
+            worker.tasks.pop_back( );
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // steal: FIFO (skip busy victims first)
+    bool contended = false;
+    for (std::size_t i = 1; i < workers.size( ); ++i)
+    {
+        Worker &victim = *workers[(index + i) % workers.size( )];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock( ))
+        {
+            contended = true;
+            continue;
+        }
+        if (!victim.tasks.empty( ))
+        {
+            task = std::move(victim.tasks.front( ));
+            victim.tasks.pop_front( );
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // a skipped victim may hold the queued task: the worker would not sleep (queued != 0) but spin
+    // --> final pass with blocking locks
+    if (!contended) return false;
+    for (std::size_t i = 1; i < workers.size( ); ++i)
+    {
+        Worker &victim = *workers[(index + i) % workers.size( )];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty( ))
+        {
+            task = std::move(victim.tasks.front( ));
+            victim.tasks.pop_front( );
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::execute(Task_t &task) noexcept
+{
+    try
+    {
+        task( );
+    }
+    catch (const std::exception &e)
+    {
+        SignalHandler::get_error_stream( ) << "WorkStealingPool: task failed: " << e.what( ) << std::endl;
+    }
+    catch (...)
+    {
+        SignalHandler::get_error_stream( ) << "WorkStealingPool: task failed: unknown exception" << std::endl;
+    }
+}
+
+void WorkStealingPool::run_worker(std::size_t index)
+{
+    current_pool = this;
+    current_worker = index;
+
+    for (;;)
+    {
+        Task_t task;
+        if (next_task(index, task))
+        {
+            execute(task);
+            task = nullptr;	// destroy captures before the task is marked as finished
+
+            if (pending.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex);
+                done_condition.notify_all( );
+            }
+            continue;
+        }
+
+        // sleep until a task is queued (checked under lock --> no lost wakeup)
+        std::unique_lock<std::mutex> lock(idle_mutex);
+        idle_condition.wait(lock, [this]( ) { return stop || queued.load( ) != 0; });
+        if (stop && queued.load( ) == 0) return;
+    }
+}
+
+void WorkStealingPool::wait_idle( )
+{
+    std::unique_lock<std::mutex> lock(idle_mutex);
+    done_condition.wait(lock, [this]( ) { return pending.load( ) == 0; });
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
@@ -0,0 +1,151 @@
+/*
+ * \file WorkStealingPool.hpp
+ * \brief Header file de::Koesling::Signal::WorkStealingPool
+ *
+ * required compiler options:
+ *          -std=c++11 (or higher)
+ *          -pthread
+ *
+ * recommended compiler options:
+ *          -O2
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace de {
+namespace Koesling {
+namespace Signal {
+
+/*! \brief Thread pool with work stealing
+ *
+ * Every worker owns a task deque. Workers execute their own tasks LIFO and
+ * steal tasks FIFO from other workers if their deque is empty.
+ *
+ * Tasks that are submitted with a key are serialized per key: tasks with
+ * the same key are never executed concurrently and are executed in
+ * submission order. (Keys are mapped to a fixed number of strands, so
+ * different keys may share a strand.)
+ *
+ * Exceptions thrown by tasks are written to the error stream of
+ * SignalHandler (see SignalHandler::set_error_stream).
+ */
+class WorkStealingPool
+{
+    public:
+        //! task type
+        typedef std::function<void( )> Task_t;
+
+    private:
+        //! task deque of one worker
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<Task_t> tasks;
+        };
+
+        //! serialized task queue
+        struct Strand
+        {
+            std::mutex mutex;
+            std::deque<Task_t> tasks;
+            bool scheduled = false;
+        };
+
+        //! workers (one per thread)
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        //! strands for keyed tasks
+        std::vector<std::unique_ptr<Strand>> strands;
+
+        //! worker threads
+        std::vector<std::thread> threads;
+
+        //! number of submitted, but not finished tasks
+        std::atomic<std::size_t> pending;
+
+        //! number of tasks stored in the worker deques
+        std::atomic<std::size_t> queued;
+
+        //! round robin index for tasks submitted by foreign threads
+        std::atomic<std::size_t> next_worker;
+
+        //! idle workers wait for tasks
+        std::mutex idle_mutex;
+        std::condition_variable idle_condition;
+
+        //! wait_idle() waits for pending == 0
+        std::condition_variable done_condition;
+
+        //! stop workers
+        bool stop;
+
+        //! worker thread
+        void run_worker(std::size_t index);
+
+        //! get next task (own deque first, steal otherwise)
+        bool next_task(std::size_t index, Task_t &task);
+
+        //! execute all tasks of a strand (in order)
+        void run_strand(Strand &strand);
+
+        //! execute task and handle exceptions
+        void execute(Task_t &task) noexcept;
+
+    public:
+        /*! \brief create and start the thread pool
+         *
+         * attributes:
+         *   threads: number of worker threads (0: number of cpus)
+         *   strands: number of strands used to serialize keyed tasks
+         * possible_throws:
+         *   std::invalid_argument: strands is 0
+         *   std::system_error    : failed to create thread
+         */
+        explicit WorkStealingPool(std::size_t threads = 0, std::size_t strands = 64);
+
+        //! finish all pending tasks and stop the thread pool
+        ~WorkStealingPool( );
+
+        //! submit task
+        void submit(Task_t task);
+
+        //! submit task that is serialized with all other tasks with the same key
+        void submit(std::uint64_t key, Task_t task);
+
+        /*! \brief wait until all submitted tasks are finished
+         *
+         * must not be called by a task of this pool
+         */
+        void wait_idle( );
+
+        //! get number of worker threads
+        inline std::size_t get_thread_count( ) const noexcept;
+
+        //! copying not allowed
+        WorkStealingPool(const WorkStealingPool &other) = delete;
+        //! copying not allowed
+        WorkStealingPool& operator=(const WorkStealingPool &other) = delete;
+};
+
+inline std::size_t WorkStealingPool::get_thread_count( ) const noexcept
+{
+    return threads.size( );
+}
+
+} /* namespace Signal */
+} /* namespace Koesling */
+} /* namespace de */
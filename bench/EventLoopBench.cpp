@@ -0,0 +1,130 @@
+/*
+ * \file EventLoopBench.cpp
+ * \brief Benchmark: EventLoop iteration cost compared to a self-pipe design
+ *
+ * Measures the cost per loop iteration of
+ *   - an empty iteration (timeout 0, no events)
+ *   - an iteration that dispatches one signal sent to the loop thread
+ * for EventLoop (signals unmasked only during epoll_pwait2) and for a
+ * classic self-pipe loop (handler writes to a pipe watched by epoll_wait).
+ *
+ * usage: EventLoopBench [iterations]
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "EventLoop.hpp"
+#include "SignalEvent.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace de::Koesling::Signal;
+
+static int self_pipe[2];
+static volatile sig_atomic_t self_pipe_pending = 0;
+
+static void self_pipe_handler(int)
+{
+    const int saved_errno = errno;
+    self_pipe_pending = 1;
+    char byte = 0;
+    static_cast<void>(write(self_pipe[1], &byte, 1));
+    errno = saved_errno;
+}
+
+static void send_to_self(int signal_number)
+{
+    syscall(SYS_tgkill, getpid( ), syscall(SYS_gettid), signal_number);
+}
+
+static void print_result(const char *mode, long iterations, long dispatched, std::uint64_t duration)
+{
+    printf("%-32s %10ld iterations %10ld dispatched %8.1f ns/iteration\n", mode, iterations, dispatched,
+            static_cast<double>(duration) / iterations);
+}
+
+static void bench_event_loop(int signal_number, long iterations)
+{
+    EventLoop loop;
+    long dispatched = 0;
+    loop.add_signal(signal_number, [&dispatched](int) { ++dispatched; });
+
+    std::uint64_t start = monotonic_ns( );
+    for (long i = 0; i < iterations; ++i)
+        loop.run_once(std::chrono::nanoseconds(0));
+    print_result("EventLoop empty", iterations, dispatched, monotonic_ns( ) - start);
+
+    start = monotonic_ns( );
+    for (long i = 0; i < iterations; ++i)
+    {
+        send_to_self(signal_number);	// blocked --> delivered during the wait
+        loop.run_once( );
+    }
+    print_result("EventLoop signal", iterations, dispatched, monotonic_ns( ) - start);
+}
+
+static void bench_self_pipe(int signal_number, long iterations)
+{
+    if (pipe2(self_pipe, O_NONBLOCK | O_CLOEXEC) != 0) return;
+    const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = self_pipe[0];
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, self_pipe[0], &event);
+
+    SignalHandler handler(signal_number, self_pipe_handler, SA_RESTART);
+    handler.establish( );
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, signal_number);
+    pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+
+    long dispatched = 0;
+    epoll_event events[64];
+    auto iteration = [&](int timeout) {
+        const int count = epoll_wait(epoll_fd, events, 64, timeout);
+        for (int i = 0; i < count; ++i)
+        {
+            char buffer[64];
+            while (read(self_pipe[0], buffer, sizeof(buffer)) > 0)
+                ;
+            if (self_pipe_pending)
+            {
+                self_pipe_pending = 0;
+                ++dispatched;
+            }
+        }
+    };
+
+    std::uint64_t start = monotonic_ns( );
+    for (long i = 0; i < iterations; ++i)
+        iteration(0);
+    print_result("self-pipe empty", iterations, dispatched, monotonic_ns( ) - start);
+
+    start = monotonic_ns( );
+    for (long i = 0; i < iterations; ++i)
+    {
+        send_to_self(signal_number);	// handler runs before tgkill returns
+        iteration(-1);
+    }
+    print_result("self-pipe signal", iterations, dispatched, monotonic_ns( ) - start);
+
+    handler.revoke( );
+    close(epoll_fd);
+    close(self_pipe[0]);
+    close(self_pipe[1]);
+}
+
+int main(int argc, char **argv)
+{
+    const long iterations = argc > 1 ? atol(argv[1]) : 100000;
+
+    bench_self_pipe(SIGUSR1, iterations);
+    bench_event_loop(SIGUSR2, iterations);
+}
@@ -0,0 +1,191 @@
+/*
+ * \file FutexSignalHandlerBench.cpp
+ * \brief Benchmark: handoff latency from a signal to a waiting consumer thread
+ *
+ * The main thread sends a signal to itself, the consumer thread is blocked
+ * until the delivery is handed off. Measured is the time from sending the
+ * signal until the consumer runs, for
+ *   - FutexSignalHandler (futex wake from the handler)
+ *   - eventfd written by the handler
+ *   - pipe written by the handler (self pipe)
+ *   - signalfd read by the consumer (no handler)
+ *
+ * usage: FutexSignalHandlerBench [rounds]
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "FutexSignalHandler.hpp"
+#include "SignalEvent.hpp"
+#include "SignalFd.hpp"
+#include "SignalHandler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace de::Koesling::Signal;
+
+static int handoff_fd = -1;
+
+static void write_eventfd(int)
+{
+    const int saved_errno = errno;
+    std::uint64_t value = 1;
+    static_cast<void>(write(handoff_fd, &value, sizeof(value)));
+    errno = saved_errno;
+}
+
+static void write_pipe(int)
+{
+    const int saved_errno = errno;
+    char byte = 0;
+    static_cast<void>(write(handoff_fd, &byte, 1));
+    errno = saved_errno;
+}
+
+// handled by the calling thread (the consumer blocks the signal)
+static void send_to_self(int signal_number)
+{
+    syscall(SYS_tgkill, getpid( ), syscall(SYS_gettid), signal_number);
+}
+
+// process directed: pending until the consumer reads the signalfd
+static void send_to_process(int signal_number)
+{
+    union sigval value;
+    value.sival_int = 0;
+    sigqueue(getpid( ), signal_number, value);
+}
+
+/*
+ * rounds of: store send time, send signal, wait for the consumer
+ * The consumer calls wait_one() and records the handoff latency.
+ */
+static void bench(const char *mode, int signal_number, long rounds, const std::function<void( )> &send,
+        const std::function<void( )> &wait_one)
+{
+    std::atomic<std::uint64_t> sent(0);
+    std::atomic<long> acknowledged(0);
+    std::vector<std::uint64_t> latency(static_cast<std::size_t>(rounds));
+
+    std::thread consumer([&]( ) {
+        // the handler must run in the sending thread
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, signal_number);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        for (long i = 0; i < rounds; ++i)
+        {
+            wait_one( );
+            latency[static_cast<std::size_t>(i)] = monotonic_ns( ) - sent.load( );
+            acknowledged.store(i + 1);
+        }
+    });
+
+    for (long i = 0; i < rounds; ++i)
+    {
+        sent.store(monotonic_ns( ));
+        send( );
+        while (acknowledged.load( ) != i + 1)
+            sched_yield( );
+    }
+    consumer.join( );
+
+    std::sort(latency.begin( ), latency.end( ));
+    std::uint64_t sum = 0;
+    for (std::uint64_t value : latency)
+        sum += value;
+
+    const std::size_t count = latency.size( );
+    printf("%-10s %8ld rounds  mean %8.0f ns  p50 %8llu ns  p99 %8llu ns  p99.9 %8llu ns\n", mode, rounds,
+            static_cast<double>(sum) / static_cast<double>(count),
+            static_cast<unsigned long long>(latency[count / 2]),
+            static_cast<unsigned long long>(latency[count * 99 / 100]),
+            static_cast<unsigned long long>(latency[count * 999 / 1000]));
+}
+
+static void bench_futex(int signal_number, long rounds)
+{
+    FutexSignalHandler handler(signal_number);
+    handler.establish( );
+
+    std::uint32_t last = handler.get_sequence( );
+    bench("futex", signal_number, rounds, [signal_number]( ) { send_to_self(signal_number); }, [&]( ) {
+        last = handler.wait(last);
+    });
+}
+
+static void bench_eventfd(int signal_number, long rounds)
+{
+    handoff_fd = eventfd(0, EFD_CLOEXEC);
+    SignalHandler handler(signal_number, write_eventfd);
+    handler.establish( );
+
+    bench("eventfd", signal_number, rounds, [signal_number]( ) { send_to_self(signal_number); }, []( ) {
+        std::uint64_t value;
+        while (read(handoff_fd, &value, sizeof(value)) == -1 && errno == EINTR)
+            ;
+    });
+
+    handler.revoke( );
+    close(handoff_fd);
+}
+
+static void bench_pipe(int signal_number, long rounds)
+{
+    int fds[2];
+    if (pipe(fds) != 0) return;
+    handoff_fd = fds[1];
+    SignalHandler handler(signal_number, write_pipe);
+    handler.establish( );
+
+    bench("pipe", signal_number, rounds, [signal_number]( ) { send_to_self(signal_number); }, [&fds]( ) {
+        char byte;
+        while (read(fds[0], &byte, 1) == -1 && errno == EINTR)
+            ;
+    });
+
+    handler.revoke( );
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// the signal stays blocked afterwards
+static void bench_signalfd(int signal_number, long rounds)
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, signal_number);
+    SignalFd signal_fd(signals, SFD_CLOEXEC);	// blocking read
+
+    bench("signalfd", signal_number, rounds, [signal_number]( ) { send_to_process(signal_number); }, [&]( ) {
+        signalfd_siginfo info;
+        while (read(signal_fd.get_fd( ), &info, sizeof(info)) == -1 && errno == EINTR)
+            ;
+    });
+}
+
+int main(int argc, char **argv)
+{
+    const long rounds = argc > 1 ? atol(argv[1]) : 100000;
+    const int signal_number = SIGRTMIN;
+
+    printf("%u cpus\n", std::thread::hardware_concurrency( ));
+
+    // handler modes first: signalfd blocks the signal
+    bench_futex(signal_number, rounds);
+    bench_eventfd(signal_number, rounds);
+    bench_pipe(signal_number, rounds);
+    bench_signalfd(signal_number, rounds);
+}
@@ -0,0 +1,123 @@
+/*
+ * \file IoUringSignalSourceBench.cpp
+ * \brief Benchmark: signal delivery via sigaction, signalfd and io_uring
+ *
+ * Queues batches of realtime signals to the own process and measures the
+ * cost per signal (sigqueue + delivery) of
+ *   - a handler established by SignalHandler::establish()
+ *   - signalfd read via SignalFdReader
+ *   - IoUringSignalSource (single read requests and multishot poll)
+ *
+ * usage: IoUringSignalSourceBench [rounds]
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "IoUringSignalSource.hpp"
+#include "SignalFdReader.hpp"
+#include "SignalHandler.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace de::Koesling::Signal;
+
+//! signals per batch (below RLIMIT_SIGPENDING)
+static constexpr int BATCH = 32;
+
+static volatile sig_atomic_t handled = 0;
+
+static void count_signal(int)
+{
+    handled = handled + 1;
+}
+
+static void queue_batch(int signal_number)
+{
+    union sigval value;
+    value.sival_int = 0;
+    for (int i = 0; i < BATCH; ++i)
+        sigqueue(getpid( ), signal_number, value);
+}
+
+static void print_result(const char *mode, long signals, std::uint64_t duration)
+{
+    printf("%-28s %10ld signals %10.1f ns/signal\n", mode, signals, static_cast<double>(duration) / signals);
+}
+
+static void bench_sigaction(int signal_number, int rounds)
+{
+    SignalHandler handler(signal_number, count_signal);
+    handler.establish( );
+
+    handled = 0;
+    const std::uint64_t start = monotonic_ns( );
+    for (int round = 0; round < rounds; ++round)
+        queue_batch(signal_number);	// delivered before sigqueue returns
+    const std::uint64_t duration = monotonic_ns( ) - start;
+
+    handler.revoke( );
+    print_result("sigaction (establish)", handled, duration);
+}
+
+static void bench_signalfd(const sigset_t &signals, int signal_number, int rounds)
+{
+    SignalFd signal_fd(signals);
+    SignalFdReader reader(BATCH);
+
+    long received = 0;
+    const std::uint64_t start = monotonic_ns( );
+    for (int round = 0; round < rounds; ++round)
+    {
+        queue_batch(signal_number);
+        received += static_cast<long>(reader.read(signal_fd).size);
+    }
+    const std::uint64_t duration = monotonic_ns( ) - start;
+
+    print_result("signalfd read", received, duration);
+}
+
+static void bench_io_uring(const sigset_t &signals, int signal_number, int rounds, bool multishot)
+{
+    IoUring ring(8);
+    IoUringSignalSource source(signals, 1, BATCH, multishot);
+    source.arm(ring);
+    ring.submit( );
+
+    long received = 0;
+    const std::uint64_t start = monotonic_ns( );
+    for (int round = 0; round < rounds; ++round)
+    {
+        queue_batch(signal_number);
+        const long goal = static_cast<long>(round + 1) * BATCH;
+        while (received < goal)
+        {
+            io_uring_cqe *cqe = ring.wait_cqe( );
+            if (source.owns(*cqe)) received += static_cast<long>(source.handle(ring, *cqe).size);
+            ring.cqe_seen( );
+            while (source.has_pending( ))
+                received += static_cast<long>(source.read_pending( ).size);
+        }
+    }
+    const std::uint64_t duration = monotonic_ns( ) - start;
+
+    print_result(source.is_multishot( ) ? "io_uring (multishot poll)" : "io_uring (single read)", received,
+            duration);
+}
+
+int main(int argc, char **argv)
+{
+    const int rounds = argc > 1 ? atoi(argv[1]) : 10000;
+    const int signal_number = SIGRTMIN;
+
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, signal_number);
+
+    // handler path first: the signalfd benchmarks block the signal
+    bench_sigaction(signal_number, rounds);
+    bench_signalfd(signals, signal_number, rounds);
+    bench_io_uring(signals, signal_number, rounds, false);
+    bench_io_uring(signals, signal_number, rounds, true);
+}
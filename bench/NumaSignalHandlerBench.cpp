@@ -0,0 +1,112 @@
+/*
+ * \file NumaSignalHandlerBench.cpp
+ * \brief Benchmark: NumaSignalHandler throughput with 1 to 256 concurrent senders
+ *
+ * Every sender thread queues signals to itself (pthread_sigqueue), so the
+ * handler runs on the cpu of the sender. Measured is the time until the
+ * consumer processed all delivered events for
+ *   - NumaSignalHandler (one queue per node)
+ *   - NumaSignalHandler (one queue per cpu)
+ *   - BatchSignalHandler (one shared queue)
+ *
+ * usage: NumaSignalHandlerBench [signals per sender]
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "BatchSignalHandler.hpp"
+#include "NumaSignalHandler.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <pthread.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace de::Koesling::Signal;
+
+//! capacity of every queue (large enough to avoid drops)
+static constexpr std::size_t QUEUE_CAPACITY = 1 << 16;
+
+//! send signals from all senders, wait until all sent signals are processed (received or dropped)
+static std::uint64_t run_senders(int signal_number, unsigned senders, long signals,
+        const std::function<long( )> &processed, long &sent)
+{
+    std::atomic<long> sent_count(0);
+    std::atomic<bool> go(false);
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < senders; ++i)
+        threads.emplace_back([&]( ) {
+            while (!go.load( ))
+                std::this_thread::yield( );
+            union sigval value;
+            value.sival_int = 0;
+            for (long n = 0; n < signals; ++n)
+                if (pthread_sigqueue(pthread_self( ), signal_number, value) == 0) sent_count.fetch_add(1);
+        });
+
+    const std::uint64_t start = monotonic_ns( );
+    go.store(true);
+    for (auto &thread : threads)
+        thread.join( );
+    sent = sent_count.load( );
+
+    while (processed( ) < sent)
+        std::this_thread::yield( );
+    return monotonic_ns( ) - start;
+}
+
+static void print_result(const char *mode, unsigned senders, long sent, std::uint64_t dropped,
+        std::uint64_t duration)
+{
+    printf("%-16s %4u senders %10ld signals %8lu dropped %10.0f signals/s\n", mode, senders, sent,
+            static_cast<unsigned long>(dropped), static_cast<double>(sent - static_cast<long>(dropped)) * 1e9 / duration);
+}
+
+static void bench_numa(NumaSignalHandler::Sharding sharding, unsigned senders, long signals)
+{
+    std::atomic<long> received(0);
+    NumaSignalHandler handler(SIGRTMIN, [&received](const SignalEvent&) { received.fetch_add(1); }, sharding,
+            QUEUE_CAPACITY);
+    handler.establish( );
+
+    long sent = 0;
+    const std::uint64_t duration = run_senders(SIGRTMIN, senders, signals, [&]( ) {
+        return received.load( ) + static_cast<long>(handler.get_dropped( ));
+    }, sent);
+
+    print_result(sharding == NumaSignalHandler::Sharding::NODE ? "numa (node)" : "numa (cpu)", senders, sent,
+            handler.get_dropped( ), duration);
+}
+
+static void bench_shared(unsigned senders, long signals)
+{
+    std::atomic<long> received(0);
+    BatchSignalHandler handler(SIGRTMIN, [&received](SignalEventSpan events) {
+        received.fetch_add(static_cast<long>(events.size));
+    }, QUEUE_CAPACITY);
+    handler.establish( );
+
+    long sent = 0;
+    const std::uint64_t duration = run_senders(SIGRTMIN, senders, signals, [&]( ) {
+        return received.load( ) + static_cast<long>(handler.get_dropped( ));
+    }, sent);
+
+    print_result("shared queue", senders, sent, handler.get_dropped( ), duration);
+}
+
+int main(int argc, char **argv)
+{
+    const long signals = argc > 1 ? atol(argv[1]) : 10000;
+
+    printf("%u cpus, %u NUMA nodes\n", std::thread::hardware_concurrency( ), NumaSignalHandler::node_count( ));
+    for (unsigned senders = 1; senders <= 256; senders *= 2)
+    {
+        bench_numa(NumaSignalHandler::Sharding::NODE, senders, signals);
+        bench_numa(NumaSignalHandler::Sharding::CPU, senders, signals);
+        bench_shared(senders, signals);
+    }
+}
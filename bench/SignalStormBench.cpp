@@ -0,0 +1,213 @@
+/*
+ * \file SignalStormBench.cpp
+ * \brief Benchmark: signal storm against the delivery modes of the library
+ *
+ * Runs the same mixed storm (one standard and two realtime signals, sender
+ * threads and one sender process, blocking pipe I/O) against
+ *   - a handler established by SignalHandler (SignalTrampoline sink)
+ *   - BatchSignalHandler (handler queue + dispatcher thread)
+ *   - signalfd read via SignalFdReader (reader thread)
+ *   - IoUringSignalSource (multishot poll, reader thread)
+ * and prints throughput, lost realtime signals and delivery latency per mode.
+ *
+ * usage: SignalStormBench [signals per sender]
+ *
+ * Copyright (c) 2020 Nikolas Koesling
+ *
+ */
+
+#include "BatchSignalHandler.hpp"
+#include "IoUringSignalSource.hpp"
+#include "SignalFdReader.hpp"
+#include "SignalHandler.hpp"
+#include "SignalStorm.hpp"
+#include "SignalTrampoline.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <poll.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace de::Koesling::Signal;
+
+//! trampoline sink: records in signal handler context
+class StormSink : public SignalSink
+{
+    private:
+        SignalStorm &storm;
+
+    public:
+        explicit StormSink(SignalStorm &storm) :
+                storm(storm)
+        {
+        }
+
+        void on_signal(int, siginfo_t *info, void*) noexcept override
+        {
+            storm.record(*info);
+        }
+};
+
+static SignalStormConfig make_config(std::uint32_t signals_per_sender)
+{
+    SignalStormConfig config;
+    config.signals = { SIGUSR1, SIGRTMIN, SIGRTMIN + 1 };
+    config.sender_threads = 4;
+    config.sender_processes = 1;
+    config.signals_per_sender = signals_per_sender;
+    config.io_threads = 1;
+    return config;
+}
+
+static sigset_t make_set(const SignalStormConfig &config)
+{
+    sigset_t signals;
+    sigemptyset(&signals);
+    for (int signal_number : config.signals)
+        sigaddset(&signals, signal_number);
+    return signals;
+}
+
+static void print_result(const char *mode, const SignalStormResult &result)
+{
+    printf("%-22s %12.0f signals/s  lost %6llu  p50 %9llu ns  p99 %9llu ns  p99.9 %9llu ns  max %9llu ns"
+            "  EINTR %llu\n", mode, result.get_throughput( ),
+            static_cast<unsigned long long>(result.get_realtime_lost( )),
+            static_cast<unsigned long long>(result.latency_p50),
+            static_cast<unsigned long long>(result.latency_p99),
+            static_cast<unsigned long long>(result.latency_p999),
+            static_cast<unsigned long long>(result.latency_max),
+            static_cast<unsigned long long>(result.io_interrupted));
+}
+
+static void bench_sigaction(const SignalStormConfig &config)
+{
+    SignalStorm storm(config);
+    StormSink sink(storm);
+
+    std::vector<std::unique_ptr<SignalHandler>> handlers;
+    for (int signal_number : config.signals)
+    {
+        SignalTrampoline::attach(signal_number, &sink);
+        handlers.emplace_back(new SignalHandler(signal_number, SignalTrampoline::handler, SA_RESTART));
+        handlers.back( )->establish( );
+    }
+
+    const SignalStormResult result = storm.run( );
+
+    for (int signal_number : config.signals)
+        SignalTrampoline::detach(signal_number, &sink);
+    handlers.clear( );
+    print_result("sigaction", result);
+}
+
+static void bench_batch(const SignalStormConfig &config)
+{
+    SignalStorm storm(config);
+
+    const SignalBatchHandler_t record = [&storm](SignalEventSpan events) {
+        for (const SignalEvent &event : events)
+            storm.record(event);
+    };
+
+    // over-aligned: no heap allocation (see make_config for the signals)
+    BatchSignalHandler standard(config.signals[0], record, 1 << 16);
+    BatchSignalHandler realtime_0(config.signals[1], record, 1 << 16);
+    BatchSignalHandler realtime_1(config.signals[2], record, 1 << 16);
+    standard.establish( );
+    realtime_0.establish( );
+    realtime_1.establish( );
+
+    const SignalStormResult result = storm.run( );
+
+    print_result("BatchSignalHandler", result);
+}
+
+// the signals stay blocked afterwards: only fd based modes may follow
+static void bench_signalfd(const SignalStormConfig &config)
+{
+    SignalStorm storm(config);
+    SignalFd signal_fd(make_set(config));
+    std::atomic<bool> stop(false);
+
+    // created after SignalFd: the reader inherits the blocked signals
+    std::thread reader([&]( ) {
+        SignalFdReader fd_reader(64);
+        struct pollfd poll_fd = { signal_fd.get_fd( ), POLLIN, 0 };
+        while (!stop.load( ))
+        {
+            if (poll(&poll_fd, 1, 10) <= 0) continue;
+            bool more_pending = true;
+            while (more_pending)
+                for (const SignalEvent &event : fd_reader.drain(signal_fd, more_pending))
+                    storm.record(event);
+        }
+    });
+
+    const SignalStormResult result = storm.run( );
+
+    stop.store(true);
+    reader.join( );
+    print_result("signalfd", result);
+}
+
+static void bench_io_uring(const SignalStormConfig &config)
+{
+    SignalStorm storm(config);
+    IoUring ring(8);
+    IoUringSignalSource source(make_set(config), 1, 64, true);
+    std::atomic<bool> stop(false);
+
+    std::thread reader([&]( ) {
+        source.arm(ring);
+        ring.submit( );
+        for (;;)
+        {
+            io_uring_cqe *cqe = ring.wait_cqe( );
+            const bool done = stop.load( );
+            if (source.owns(*cqe))
+            {
+                const SignalEventSpan events = source.handle(ring, *cqe);
+                if (!done)
+                    for (const SignalEvent &event : events)
+                        storm.record(event);
+            }
+            ring.cqe_seen( );
+            while (!done && source.has_pending( ))
+                for (const SignalEvent &event : source.read_pending( ))
+                    storm.record(event);
+            if (done) return;
+        }
+    });
+
+    const SignalStormResult result = storm.run( );
+
+    // wake the reader (the wakeup signal is not recorded)
+    stop.store(true);
+    union sigval value;
+    value.sival_int = 0;
+    sigqueue(getpid( ), SIGRTMIN, value);
+    reader.join( );
+    print_result(source.is_multishot( ) ? "io_uring (multishot)" : "io_uring (single read)", result);
+}
+
+int main(int argc, char **argv)
+{
+    const SignalStormConfig config = make_config(argc > 1 ? static_cast<std::uint32_t>(atol(argv[1])) : 20000);
+
+    // signals that arrive after a mode finished must not terminate the process
+    for (int signal_number : config.signals)
+        signal(signal_number, SIG_IGN);
+
+    printf("%zu sender threads, %zu sender processes, %u signals per sender\n", config.sender_threads,
+            config.sender_processes, config.signals_per_sender);
+
+    // handler modes first: the fd modes block the signals
+    bench_sigaction(config);
+    bench_batch(config);
+    bench_signalfd(config);
+    bench_io_uring(config);
+}